@@ -0,0 +1,67 @@
+#include "AnalyzerFeed.h"
+#include <algorithm>
+
+MT2AnalyzerFeed::MT2AnalyzerFeed()
+    : mRing(static_cast<size_t>(mFifo.getTotalSize()))
+{
+}
+
+void MT2AnalyzerFeed::prepare(double sampleRate)
+{
+    mSampleRate.store(sampleRate, std::memory_order_relaxed);
+    mFrameInterval = std::max(kFrameSize, static_cast<int>(sampleRate / kFramesPerSecond));
+
+    // A frame in progress is finished at the new rate rather than cut short,
+    // which would misalign every later frame for the reader
+    mUntilNextFrame = 0;
+}
+
+template <typename FloatType>
+void MT2AnalyzerFeed::push(const FloatType* left, const FloatType* right, int numSamples)
+{
+    int pos = 0;
+    while (pos < numSamples) {
+        if (mFrameRemaining == 0) {
+            // Between frames: only start one if someone reads and it fits whole
+            if (!isActive()) return;
+
+            const int skip = std::min(numSamples - pos, std::max(0, mUntilNextFrame));
+            pos += skip;
+            mUntilNextFrame -= skip;
+            if (mUntilNextFrame > 0 || pos == numSamples) return;
+
+            mUntilNextFrame = mFrameInterval;
+            if (mFifo.getFreeSpace() < kFrameSize) continue;   // reader behind: drop this frame
+            mFrameRemaining = kFrameSize;
+        }
+
+        const int count = std::min(numSamples - pos, mFrameRemaining);
+        const auto scope = mFifo.write(count);
+        auto copy = [&](int start, int size, int offset) {
+            for (int i = 0; i < size; ++i) {
+                const int n = pos + offset + i;
+                mRing[static_cast<size_t>(start + i)] = static_cast<float>(0.5 * (left[n] + right[n]));
+            }
+        };
+        copy(scope.startIndex1, scope.blockSize1, 0);
+        copy(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+
+        pos += count;
+        mFrameRemaining -= count;
+        mUntilNextFrame -= count;
+    }
+}
+
+bool MT2AnalyzerFeed::pullFrame(float* dest)
+{
+    if (mFifo.getNumReady() < kFrameSize)
+        return false;
+
+    const auto scope = mFifo.read(kFrameSize);
+    std::copy_n(mRing.data() + scope.startIndex1, scope.blockSize1, dest);
+    std::copy_n(mRing.data() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+    return true;
+}
+
+template void MT2AnalyzerFeed::push(const float*, const float*, int);
+template void MT2AnalyzerFeed::push(const double*, const double*, int);
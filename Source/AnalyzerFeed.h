@@ -0,0 +1,59 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <vector>
+
+/** Audio-thread end of the analyzer: mono output samples into a lock-free
+    single-producer / single-consumer ring (juce::AbstractFifo).
+
+    The stream is decimated in time, not in frequency: the audio thread
+    copies whole frames of kFrameSize consecutive samples, at most
+    kFramesPerSecond of them, and skips the samples in between. Every
+    frame keeps the full band (aliasing included) while the audio thread
+    writes no more than kFrameSize · kFramesPerSecond samples a second
+    whatever the sample rate. A frame only starts if it fits in the ring,
+    so the reader always finds whole frames and a stalled reader just
+    causes frames to be dropped.
+
+    Nothing is copied while no reader is attached (one flag read per block).
+*/
+class MT2AnalyzerFeed {
+public:
+    static constexpr int kFrameSize = 2048;
+    static constexpr int kFramesPerSecond = 20;
+
+    MT2AnalyzerFeed();
+
+    /** Not real-time safe. */
+    void prepare(double sampleRate);
+
+    /** Reader side: the feed only runs while a reader is attached. */
+    void attach() { mReaders.fetch_add(1, std::memory_order_relaxed); }
+    void detach() { mReaders.fetch_sub(1, std::memory_order_relaxed); }
+    bool isActive() const { return mReaders.load(std::memory_order_relaxed) > 0; }
+
+    double getSampleRate() const { return mSampleRate.load(std::memory_order_relaxed); }
+
+    /** Audio thread: (left + right) / 2 (pass the same pointer twice for mono). */
+    template <typename FloatType>
+    void push(const FloatType* left, const FloatType* right, int numSamples);
+
+    /** Reader thread: copies the oldest whole frame (kFrameSize samples) into
+        dest. Returns false if no whole frame is ready. */
+    bool pullFrame(float* dest);
+
+private:
+    juce::AbstractFifo mFifo { 4 * kFrameSize };
+    std::vector<float> mRing;
+
+    std::atomic<double> mSampleRate { 44100.0 };
+    std::atomic<int> mReaders { 0 };
+
+    // Audio thread only
+    int mFrameInterval = kFrameSize;   // samples from one frame start to the next
+    int mUntilNextFrame = 0;
+    int mFrameRemaining = 0;           // > 0 while copying a frame
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MT2AnalyzerFeed)
+};
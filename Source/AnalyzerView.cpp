@@ -0,0 +1,206 @@
+#include "AnalyzerView.h"
+#include <algorithm>
+#include <cmath>
+
+MT2AnalyzerView::MT2AnalyzerView(MT2AnalyzerFeed& feed)
+    : mFeed(feed),
+      mFrame(static_cast<size_t>(kFftSize)),
+      mFftData(static_cast<size_t>(2 * kFftSize))
+{
+    mWork.spectrumDb.fill(kMinDb);
+    mShown = mWork;
+
+    setOpaque(true);
+    mFeed.attach();
+    mThread->addTimeSliceClient(this);
+    startTimerHz(30);
+}
+
+MT2AnalyzerView::~MT2AnalyzerView()
+{
+    stopTimer();
+    mThread->removeTimeSliceClient(this);   // waits for a running useTimeSlice
+    mFeed.detach();
+}
+
+int MT2AnalyzerView::useTimeSlice()
+{
+    // Only the newest frame is shown: drain the ring, analyse the last one
+    bool gotFrame = false;
+    while (mFeed.pullFrame(mFrame.data()))
+        gotFrame = true;
+
+    if (gotFrame)
+        analyse(mFrame.data(), mFeed.getSampleRate());
+
+    // Poll at twice the frame rate (ms until the next call)
+    return 1000 / (2 * MT2AnalyzerFeed::kFramesPerSecond);
+}
+
+void MT2AnalyzerView::updateColumns(double sampleRate)
+{
+    // Column edges spaced evenly in log frequency, as FFT bin positions
+    const double nyquist = 0.5 * sampleRate;
+    const double binHz = sampleRate / kFftSize;
+    for (int c = 0; c <= kNumColumns; ++c) {
+        const double f = kMinFrequency * std::pow(nyquist / kMinFrequency, static_cast<double>(c) / kNumColumns);
+        mColumnBins[static_cast<size_t>(c)] = static_cast<float>(f / binHz);
+    }
+    mColumnSampleRate = sampleRate;
+}
+
+void MT2AnalyzerView::analyse(const float* frame, double sampleRate)
+{
+    if (sampleRate != mColumnSampleRate)
+        updateColumns(sampleRate);
+
+    // --- Spectrum: Hann window, magnitude, peak per column ---
+    std::copy_n(frame, kFftSize, mFftData.begin());
+    std::fill(mFftData.begin() + kFftSize, mFftData.end(), 0.0f);
+    mWindow.multiplyWithWindowingTable(mFftData.data(), static_cast<size_t>(kFftSize));
+    mFft.performFrequencyOnlyForwardTransform(mFftData.data(), true);
+
+    // A full-scale sine reads 0 dB (the Hann window sums to N/2)
+    const float scale = 4.0f / kFftSize;
+    const int lastBin = kFftSize / 2;
+    for (int c = 0; c < kNumColumns; ++c) {
+        const float b0 = mColumnBins[static_cast<size_t>(c)];
+        const float b1 = mColumnBins[static_cast<size_t>(c + 1)];
+
+        float magnitude;
+        if (b1 - b0 < 1.0f) {
+            // Narrower than a bin (low end): interpolate at the column centre
+            const float centre = std::min(0.5f * (b0 + b1), static_cast<float>(lastBin - 1));
+            const int bin = static_cast<int>(centre);
+            const float frac = centre - static_cast<float>(bin);
+            magnitude = mFftData[static_cast<size_t>(bin)] * (1.0f - frac) + mFftData[static_cast<size_t>(bin + 1)] * frac;
+        } else {
+            // Wider (high end): the loudest bin, so narrow harmonics and aliases still show
+            const int first = static_cast<int>(std::ceil(b0));
+            const int last = std::min(static_cast<int>(b1), lastBin);
+            magnitude = *std::max_element(mFftData.begin() + first, mFftData.begin() + last + 1);
+        }
+
+        const float db = juce::Decibels::gainToDecibels(magnitude * scale, kMinDb);
+        auto& shown = mWork.spectrumDb[static_cast<size_t>(c)];
+        shown = std::max(db, shown - kFallDbPerFrame);
+    }
+
+    // --- Scope: first rising zero crossing, then min/max per column ---
+    int trigger = 0;
+    for (int i = 1; i < kFftSize - kScopeSamples; ++i) {
+        if (frame[i - 1] < 0.0f && frame[i] >= 0.0f) {
+            trigger = i;
+            break;
+        }
+    }
+
+    constexpr int perColumn = kScopeSamples / kScopeColumns;
+    for (int c = 0; c < kScopeColumns; ++c) {
+        const float* first = frame + trigger + c * perColumn;
+        const auto range = std::minmax_element(first, first + perColumn);
+        mWork.scopeMin[static_cast<size_t>(c)] = *range.first;
+        mWork.scopeMax[static_cast<size_t>(c)] = *range.second;
+    }
+
+    mDisplays.write(mWork);
+}
+
+void MT2AnalyzerView::timerCallback()
+{
+    if (!mDisplays.read(mShown))
+        return;   // nothing new: no path rebuild, no repaint
+
+    if (mFeed.getSampleRate() != mGridSampleRate)
+        renderGrid();
+
+    // Spectrum: one point per column
+    mSpectrumPath.clear();
+    const auto& sa = mSpectrumArea;
+    for (int c = 0; c < kNumColumns; ++c) {
+        const float x = sa.getX() + sa.getWidth() * (static_cast<float>(c) + 0.5f) / kNumColumns;
+        const float db = juce::jlimit(kMinDb, 0.0f, mShown.spectrumDb[static_cast<size_t>(c)]);
+        const float y = juce::jmap(db, kMinDb, 0.0f, sa.getBottom(), sa.getY());
+        if (c == 0) mSpectrumPath.startNewSubPath(x, y);
+        else        mSpectrumPath.lineTo(x, y);
+    }
+
+    // Scope: band between the max and min traces (±1 fills the height)
+    mScopePath.clear();
+    const auto& oa = mScopeArea;
+    auto scopeX = [&](int c) { return oa.getX() + oa.getWidth() * (static_cast<float>(c) + 0.5f) / kScopeColumns; };
+    auto scopeY = [&](float v) { return juce::jmap(juce::jlimit(-1.0f, 1.0f, v), -1.0f, 1.0f, oa.getBottom(), oa.getY()); };
+    mScopePath.startNewSubPath(scopeX(0), scopeY(mShown.scopeMax[0]));
+    for (int c = 1; c < kScopeColumns; ++c)
+        mScopePath.lineTo(scopeX(c), scopeY(mShown.scopeMax[static_cast<size_t>(c)]));
+    for (int c = kScopeColumns - 1; c >= 0; --c)
+        mScopePath.lineTo(scopeX(c), scopeY(mShown.scopeMin[static_cast<size_t>(c)]));
+    mScopePath.closeSubPath();
+
+    repaint();
+}
+
+void MT2AnalyzerView::resized()
+{
+    auto area = getLocalBounds().toFloat();
+    mSpectrumArea = area.removeFromLeft(area.getWidth() * 0.7f).reduced(2.0f);
+    area.removeFromLeft(6.0f);
+    mScopeArea = area.reduced(2.0f);
+    renderGrid();
+}
+
+void MT2AnalyzerView::renderGrid()
+{
+    if (getWidth() <= 0 || getHeight() <= 0) return;
+
+    mGrid = juce::Image(juce::Image::RGB, getWidth(), getHeight(), true);
+    juce::Graphics g(mGrid);
+    g.fillAll(juce::Colours::darkgrey);
+
+    g.setColour(juce::Colours::black);
+    g.fillRect(mSpectrumArea);
+    g.fillRect(mScopeArea);
+
+    g.setFont(juce::Font(10.0f));
+    const auto gridColour = juce::Colours::grey.withAlpha(0.4f);
+
+    // dB lines every 24 dB
+    for (float db = -24.0f; db > kMinDb; db -= 24.0f) {
+        const float y = juce::jmap(db, kMinDb, 0.0f, mSpectrumArea.getBottom(), mSpectrumArea.getY());
+        g.setColour(gridColour);
+        g.drawHorizontalLine(juce::roundToInt(y), mSpectrumArea.getX(), mSpectrumArea.getRight());
+        g.setColour(juce::Colours::grey);
+        g.drawText(juce::String(static_cast<int>(db)), juce::Rectangle<float>(mSpectrumArea.getX() + 2.0f, y - 11.0f, 30.0f, 10.0f),
+                   juce::Justification::left);
+    }
+
+    // Decade lines (the columns end at Nyquist, so they move with the rate)
+    mGridSampleRate = mFeed.getSampleRate();
+    const double nyquist = 0.5 * mGridSampleRate;
+    for (double f : { 100.0, 1000.0, 10000.0 }) {
+        const float x = mSpectrumArea.getX()
+                      + mSpectrumArea.getWidth() * static_cast<float>(std::log(f / kMinFrequency) / std::log(nyquist / kMinFrequency));
+        g.setColour(gridColour);
+        g.drawVerticalLine(juce::roundToInt(x), mSpectrumArea.getY(), mSpectrumArea.getBottom());
+        g.setColour(juce::Colours::grey);
+        g.drawText(f < 1000.0 ? juce::String(static_cast<int>(f)) : juce::String(static_cast<int>(f / 1000.0)) + "k",
+                   juce::Rectangle<float>(x + 2.0f, mSpectrumArea.getBottom() - 11.0f, 30.0f, 10.0f), juce::Justification::left);
+    }
+
+    g.setColour(gridColour);
+    g.drawHorizontalLine(juce::roundToInt(mScopeArea.getCentreY()), mScopeArea.getX(), mScopeArea.getRight());
+}
+
+void MT2AnalyzerView::paint(juce::Graphics& g)
+{
+    if (mGrid.isValid())
+        g.drawImageAt(mGrid, 0, 0);
+    else
+        g.fillAll(juce::Colours::black);
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(mSpectrumPath, juce::PathStrokeType(1.2f));
+
+    g.setColour(juce::Colours::limegreen.withAlpha(0.8f));
+    g.fillPath(mScopePath);
+}
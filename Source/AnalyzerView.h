@@ -0,0 +1,83 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "AnalyzerFeed.h"
+#include "TripleBuffer.h"
+#include <array>
+#include <vector>
+
+/** Spectrum and oscilloscope of the plugin output.
+
+    - Frames come from MT2AnalyzerFeed. Windowing, FFT, log-frequency
+      mapping and the scope trigger run on a low-priority background thread
+      shared by every open analyzer in the process (one thread however many
+      editors are open; each does at most kFramesPerSecond FFTs a second).
+    - Display-ready data (dB per pixel column, scope min/max per column)
+      reaches the message thread through a TripleBuffer. The timer only
+      rebuilds the two paths and repaints when a new frame arrived.
+    - The grid and labels are drawn once per size into a cached image.
+*/
+class MT2AnalyzerView : public juce::Component, private juce::TimeSliceClient, private juce::Timer {
+public:
+    explicit MT2AnalyzerView(MT2AnalyzerFeed& feed);
+    ~MT2AnalyzerView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr int kFftOrder = 11;
+    static constexpr int kFftSize = 1 << kFftOrder;
+    static_assert(kFftSize == MT2AnalyzerFeed::kFrameSize, "one FFT per feed frame");
+
+    static constexpr int kNumColumns = 192;       // log-spaced, kMinFrequency … Nyquist
+    static constexpr int kScopeSamples = 512;     // after the trigger
+    static constexpr int kScopeColumns = 128;     // min/max of 4 samples each
+    static constexpr double kMinFrequency = 20.0;
+    static constexpr float kMinDb = -96.0f;
+    static constexpr float kFallDbPerFrame = 4.0f;
+
+    struct Display {
+        std::array<float, kNumColumns> spectrumDb;
+        std::array<float, kScopeColumns> scopeMin, scopeMax;
+    };
+
+    // Shared by every analyzer; stops when the last one goes away
+    struct Thread : juce::TimeSliceThread {
+        Thread() : juce::TimeSliceThread("MetalCosmos analyzer") { startThread(juce::Thread::Priority::low); }
+        ~Thread() override { stopThread(1000); }
+    };
+
+    // Background thread
+    int useTimeSlice() override;
+    void analyse(const float* frame, double sampleRate);
+    void updateColumns(double sampleRate);
+
+    // Message thread
+    void timerCallback() override;
+    void renderGrid();
+
+    MT2AnalyzerFeed& mFeed;
+    juce::SharedResourcePointer<Thread> mThread;
+
+    // Background thread only
+    juce::dsp::FFT mFft { kFftOrder };
+    juce::dsp::WindowingFunction<float> mWindow { static_cast<size_t>(kFftSize),
+                                                  juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> mFrame;
+    std::vector<float> mFftData;
+    std::array<float, kNumColumns + 1> mColumnBins {};   // FFT bin at each column edge
+    double mColumnSampleRate = 0.0;
+    Display mWork {};
+
+    TripleBuffer<Display> mDisplays;
+
+    // Message thread only
+    Display mShown {};
+    juce::Image mGrid;
+    double mGridSampleRate = 0.0;
+    juce::Rectangle<float> mSpectrumArea, mScopeArea;
+    juce::Path mSpectrumPath, mScopePath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MT2AnalyzerView)
+};
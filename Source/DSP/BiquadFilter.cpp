@@ -1,7 +1,16 @@
 #include "DSP/BiquadFilter.h"
+#include "DSP/DecayTime.h"
+#include <algorithm>
 #include <cmath>
 
-void BiquadFilter::setLowShelf(double freqHz, double gainDb, double q, double sampleRate) {
+template <typename SampleType>
+void BiquadFilter<SampleType>::setLowShelf(double freqHz, double gainDb, double q, double sampleRate) {
+    setCoefficients(makeLowShelf(freqHz, gainDb, q, sampleRate));
+}
+
+template <typename SampleType>
+typename BiquadFilter<SampleType>::Coefficients
+BiquadFilter<SampleType>::makeLowShelf(double freqHz, double gainDb, double q, double sampleRate) {
     // RBJ Audio EQ Cookbook - Low Shelf
     double A = std::pow(10.0, gainDb / 40.0);
     double omega = 2.0 * M_PI * freqHz / sampleRate;
@@ -11,23 +20,25 @@ void BiquadFilter::setLowShelf(double freqHz, double gainDb, double q, double sa
 
     double sqrtA = std::sqrt(A);
 
-    b0 = A * ((A + 1.0) - (A - 1.0) * cosW + 2.0 * sqrtA * alpha);
-    b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW);
-    b2 = A * ((A + 1.0) - (A - 1.0) * cosW - 2.0 * sqrtA * alpha);
-    a0 = (A + 1.0) + (A - 1.0) * cosW + 2.0 * sqrtA * alpha;
-    a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW);
-    a2 = (A + 1.0) + (A - 1.0) * cosW - 2.0 * sqrtA * alpha;
+    double b0 = A * ((A + 1.0) - (A - 1.0) * cosW + 2.0 * sqrtA * alpha);
+    double b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW);
+    double b2 = A * ((A + 1.0) - (A - 1.0) * cosW - 2.0 * sqrtA * alpha);
+    double a0 = (A + 1.0) + (A - 1.0) * cosW + 2.0 * sqrtA * alpha;
+    double a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW);
+    double a2 = (A + 1.0) + (A - 1.0) * cosW - 2.0 * sqrtA * alpha;
 
     // Normalize by a0
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    a0 = 1.0;
+    return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
 }
 
-void BiquadFilter::setPeak(double freqHz, double gainDb, double q, double sampleRate) {
+template <typename SampleType>
+void BiquadFilter<SampleType>::setPeak(double freqHz, double gainDb, double q, double sampleRate) {
+    setCoefficients(makePeak(freqHz, gainDb, q, sampleRate));
+}
+
+template <typename SampleType>
+typename BiquadFilter<SampleType>::Coefficients
+BiquadFilter<SampleType>::makePeak(double freqHz, double gainDb, double q, double sampleRate) {
     // RBJ Audio EQ Cookbook - Peaking EQ
     double A = std::pow(10.0, gainDb / 40.0);
     double omega = 2.0 * M_PI * freqHz / sampleRate;
@@ -35,23 +46,25 @@ void BiquadFilter::setPeak(double freqHz, double gainDb, double q, double sample
     double cosW = std::cos(omega);
     double alpha = sinW / (2.0 * q);
 
-    b0 = 1.0 + alpha * A;
-    b1 = -2.0 * cosW;
-    b2 = 1.0 - alpha * A;
-    a0 = 1.0 + alpha / A;
-    a1 = -2.0 * cosW;
-    a2 = 1.0 - alpha / A;
+    double b0 = 1.0 + alpha * A;
+    double b1 = -2.0 * cosW;
+    double b2 = 1.0 - alpha * A;
+    double a0 = 1.0 + alpha / A;
+    double a1 = -2.0 * cosW;
+    double a2 = 1.0 - alpha / A;
 
     // Normalize by a0
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    a0 = 1.0;
+    return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
 }
 
-void BiquadFilter::setHighShelf(double freqHz, double gainDb, double q, double sampleRate) {
+template <typename SampleType>
+void BiquadFilter<SampleType>::setHighShelf(double freqHz, double gainDb, double q, double sampleRate) {
+    setCoefficients(makeHighShelf(freqHz, gainDb, q, sampleRate));
+}
+
+template <typename SampleType>
+typename BiquadFilter<SampleType>::Coefficients
+BiquadFilter<SampleType>::makeHighShelf(double freqHz, double gainDb, double q, double sampleRate) {
     // RBJ Audio EQ Cookbook - High Shelf
     double A = std::pow(10.0, gainDb / 40.0);
     double omega = 2.0 * M_PI * freqHz / sampleRate;
@@ -61,36 +74,104 @@ void BiquadFilter::setHighShelf(double freqHz, double gainDb, double q, double s
 
     double sqrtA = std::sqrt(A);
 
-    b0 = A * ((A + 1.0) + (A - 1.0) * cosW + 2.0 * sqrtA * alpha);
-    b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW);
-    b2 = A * ((A + 1.0) + (A - 1.0) * cosW - 2.0 * sqrtA * alpha);
-    a0 = (A + 1.0) - (A - 1.0) * cosW + 2.0 * sqrtA * alpha;
-    a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW);
-    a2 = (A + 1.0) - (A - 1.0) * cosW - 2.0 * sqrtA * alpha;
+    double b0 = A * ((A + 1.0) + (A - 1.0) * cosW + 2.0 * sqrtA * alpha);
+    double b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW);
+    double b2 = A * ((A + 1.0) + (A - 1.0) * cosW - 2.0 * sqrtA * alpha);
+    double a0 = (A + 1.0) - (A - 1.0) * cosW + 2.0 * sqrtA * alpha;
+    double a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW);
+    double a2 = (A + 1.0) - (A - 1.0) * cosW - 2.0 * sqrtA * alpha;
 
     // Normalize by a0
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
+    return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+}
+
+template <typename SampleType>
+void BiquadFilter<SampleType>::setCoefficients(const Coefficients& c) {
+    b0 = c.b0;
+    b1 = c.b1;
+    b2 = c.b2;
     a0 = 1.0;
+    a1 = c.a1;
+    a2 = c.a2;
+}
+
+template <typename SampleType>
+double BiquadFilter<SampleType>::getTailSamples(const Coefficients& c, double decayDb) {
+    // Poles of z^2 + a1·z + a2: the one with the larger radius sets the decay
+    const double disc = c.a1 * c.a1 - 4.0 * c.a2;
+    double radius;
+    if (disc < 0.0) {
+        radius = std::sqrt(c.a2);
+    } else {
+        const double root = std::sqrt(disc);
+        radius = std::max(std::abs(-c.a1 + root), std::abs(-c.a1 - root)) * 0.5;
+    }
+    return decaySamples(radius, decayDb);
 }
 
-void BiquadFilter::reset() {
-    z1 = 0.0;
-    z2 = 0.0;
+template <typename SampleType>
+void BiquadFilter<SampleType>::reset() {
+    z1 = SampleType {};
+    z2 = SampleType {};
 }
 
-double BiquadFilter::processSample(double input) {
+template <typename SampleType>
+SampleType BiquadFilter<SampleType>::processSample(SampleType input) {
     // Direct Form II Transposed
     // y[n] = b0*x[n] + z1
     // z1    = b1*x[n] - a1*y[n] + z2
     // z2    = b2*x[n] - a2*y[n]
 
-    double output = b0 * input + z1;
+    SampleType output = b0 * input + z1;
     z1 = b1 * input - a1 * output + z2;
     z2 = b2 * input - a2 * output;
 
     return output;
 }
+
+template <typename SampleType>
+void BiquadFilter<SampleType>::process(const SampleType* in, SampleType* out, int numSamples) {
+    // Same DF-II-T recursion with coefficients and state held in registers
+    const double cb0 = b0, cb1 = b1, cb2 = b2, ca1 = a1, ca2 = a2;
+    SampleType s1 = z1, s2 = z2;
+
+    for (int i = 0; i < numSamples; ++i) {
+        SampleType input = in[i];
+        SampleType output = cb0 * input + s1;
+        s1 = cb1 * input - ca1 * output + s2;
+        s2 = cb2 * input - ca2 * output;
+        out[i] = output;
+    }
+
+    z1 = s1;
+    z2 = s2;
+}
+
+template <typename SampleType>
+void BiquadFilter<SampleType>::processRamp(const SampleType* in, SampleType* out, int numSamples,
+                                           const Coefficients& target) {
+    if (numSamples <= 0) return;
+
+    const double inv = 1.0 / numSamples;
+    const double db0 = (target.b0 - b0) * inv, db1 = (target.b1 - b1) * inv, db2 = (target.b2 - b2) * inv;
+    const double da1 = (target.a1 - a1) * inv, da2 = (target.a2 - a2) * inv;
+    double cb0 = b0, cb1 = b1, cb2 = b2, ca1 = a1, ca2 = a2;
+    SampleType s1 = z1, s2 = z2;
+
+    for (int i = 0; i < numSamples; ++i) {
+        cb0 += db0; cb1 += db1; cb2 += db2; ca1 += da1; ca2 += da2;
+        SampleType input = in[i];
+        SampleType output = cb0 * input + s1;
+        s1 = cb1 * input - ca1 * output + s2;
+        s2 = cb2 * input - ca2 * output;
+        out[i] = output;
+    }
+
+    z1 = s1;
+    z2 = s2;
+    setCoefficients(target);   // land exactly, free of accumulated rounding
+}
+
+template class BiquadFilter<double>;
+template class BiquadFilter<simd::Double2>;
+template class BiquadFilter<simd::Double4>;
@@ -1,10 +1,28 @@
 #include "DSP/DiodeFeedbackClipper.h"
+#include "DSP/FastMath.h"
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <algorithm>
 
+namespace {
+    // Upper bound of ln(y) for y ≥ 1 from the float format: y = m·2^e with
+    // m in [1, 2), and ln(m) ≤ m - 1. Over by at most 0.09, far cheaper than log.
+    inline double logUpperBound(double y) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &y, sizeof bits);
+        const double e = static_cast<double>(static_cast<int>(bits >> 52) - 1023);
+        bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+        double m;
+        std::memcpy(&m, &bits, sizeof m);
+        return e * 0.69314718055994531 + (m - 1.0);
+    }
+}
+
 void DiodeFeedbackClipper::setDiodeParams(double is, double n) {
     mIs = is;
     mN = n;
+    updateCurve();
 }
 
 void DiodeFeedbackClipper::setGain(double gain) {
@@ -15,10 +33,21 @@ void DiodeFeedbackClipper::setSampleRate(double sampleRate) {
     // Rf = 10kΩ (default feedback resistor)
     mRf = 10000.0;
     mPrevOutput = 0.0;
+    mPrevOutput2 = 0.0;
+    updateCurve();
 }
 
 void DiodeFeedbackClipper::reset() {
     mPrevOutput = 0.0;
+    mPrevOutput2 = 0.0;
+}
+
+void DiodeFeedbackClipper::setQuality(Quality quality) {
+    switch (quality) {
+    case Quality::Eco:  mTolerance = 1e-5;  mMaxIter = 4;  break;
+    case Quality::High: mTolerance = 1e-10; mMaxIter = 16; break;
+    default:            mTolerance = 1e-7;  mMaxIter = 8;  break;
+    }
 }
 
 void DiodeFeedbackClipper::setBypass(bool shouldBypass) {
@@ -27,6 +56,34 @@ void DiodeFeedbackClipper::setBypass(bool shouldBypass) {
 
 void DiodeFeedbackClipper::setRf(double rf) {
     mRf = rf;
+    updateCurve();
+}
+
+void DiodeFeedbackClipper::setSolver(Solver solver) {
+    mSolver = solver;
+    updateCurve();
+}
+
+void DiodeFeedbackClipper::setTransferTable(const DiodeTransferTable* table) {
+    mTable = table;
+    mCurveValid = false;
+    updateCurve();
+}
+
+void DiodeFeedbackClipper::updateCurve() {
+    // Normalised diode constant k = 2·Is·Rf / nVT (see DiodeTransferTable)
+    const double k = 2.0 * mIs * mRf / (mN * VT);
+    mLogHalfK = std::log(0.5 * k);
+
+    if (mSolver != Solver::Table || mTable == nullptr) {
+        mCurveValid = false;
+        return;
+    }
+
+    // setDiodeParams() is called every block, so only re-blend on change.
+    if (mCurveValid && k == mCurve.k) return;
+
+    mCurveValid = mTable->makeCurve(k, mCurve);
 }
 
 double DiodeFeedbackClipper::processSample(double input) {
@@ -35,45 +92,147 @@ double DiodeFeedbackClipper::processSample(double input) {
         return input;
     }
 
-    // Newton-Raphson iteration to solve:
-    // Vout + Rf * 2 * Is * sinh(Vout / (n * VT)) = Vin * Gain
-
     const double target = input * mGain;
+
+    if (mCurveValid) {
+        const double nVT = mN * VT;
+        const double w = mCurve.eval(target / nVT);
+        if (!std::isnan(w)) {
+            // Same output clamp as the Newton path; keeps its warm start current
+            double vout = std::clamp(w * nVT, -10.0, 10.0);
+            mPrevOutput2 = mPrevOutput;
+            mPrevOutput = vout;
+            return vout;
+        }
+        // |u| beyond the table: fall through to Newton
+    }
+
+    if (mSolver == Solver::Omega) {
+        const double vout = processOmega(target);
+        mPrevOutput2 = mPrevOutput;
+        mPrevOutput = vout;
+        return vout;
+    }
+
+    return processNewton(target);
+}
+
+void DiodeFeedbackClipper::process(const double* in, double* out, int numSamples, int stride) {
+    const int end = numSamples * stride;
+
+    if (mBypassed) {
+        if (in != out)
+            for (int i = 0; i < end; i += stride)
+                out[i] = in[i];
+        return;
+    }
+
+    if (mCurveValid) {
+        const double nVT = mN * VT;
+        const double uScale = mGain / nVT;
+        for (int i = 0; i < end; i += stride) {
+            const double w = mCurve.eval(in[i] * uScale);
+            out[i] = std::isnan(w) ? processNewton(in[i] * mGain) : std::clamp(w * nVT, -10.0, 10.0);
+        }
+        updateWarmStart(out, numSamples, stride);
+        return;
+    }
+
+    if (mSolver == Solver::Omega) {
+        for (int i = 0; i < end; i += stride)
+            out[i] = processOmega(in[i] * mGain);
+        updateWarmStart(out, numSamples, stride);
+        return;
+    }
+
+    for (int i = 0; i < end; i += stride)
+        out[i] = processNewton(in[i] * mGain);
+}
+
+void DiodeFeedbackClipper::updateWarmStart(const double* out, int numSamples, int stride) {
+    // Keeps Newton's predictors current when a non-iterative path produced the block
+    if (numSamples > 1)
+        mPrevOutput2 = out[(numSamples - 2) * stride];
+    else if (numSamples > 0)
+        mPrevOutput2 = mPrevOutput;
+    if (numSamples > 0)
+        mPrevOutput = out[(numSamples - 1) * stride];
+}
+
+double DiodeFeedbackClipper::processOmega(double target) const {
     const double nVT = mN * VT;
-    const double twoIsRf = 2.0 * mIs * mRf;
+    const double k = 2.0 * mIs * mRf / nVT;
+    const double w = DiodeTransferTable::solveOmega(target / nVT, k, mLogHalfK);
+    return std::clamp(w * nVT, -10.0, 10.0);
+}
 
-    double vout = mPrevOutput;  // Initial guess: previous output
+double DiodeFeedbackClipper::processNewton(double target) {
+    // Solve  Vout + 2·Is·Rf·sinh(Vout / nVT) = target  in the normalised form
+    // of DiodeTransferTable:  w + k·sinh(w) = u.  The solution is odd in u,
+    // so the iteration runs on |u| with w ≥ 0.
+    const double nVT = mN * VT;
+    const double k = 2.0 * mIs * mRf / nVT;
+    const double u = target / nVT;
+    const double a = std::abs(u);
+    const double sign = u < 0.0 ? -1.0 : 1.0;
+    const double tolerance = mTolerance / nVT;
+
+    // f is convex on w ≥ 0 and f(w) ≥ max((1 + k)·w, k·sinh(w)), so both
+    // inverses bound the root from above; from there Newton cannot overshoot.
+    // asinh(x) ≤ ln(2x + 1) keeps this to a few instructions.
+    double lo = 0.0;
+    double hi = std::min(a / (1.0 + k), logUpperBound(2.0 * a / k + 1.0));
+
+    double w;
+    switch (mPredictor) {
+    case Predictor::Previous: w = sign * mPrevOutput / nVT; break;
+    case Predictor::Linear:   w = sign * (2.0 * mPrevOutput - mPrevOutput2) / nVT; break;
+    default:                  w = hi; break;
+    }
+    w = std::clamp(w, lo, hi);
 
-    for (int i = 0; i < MAX_ITER; ++i) {
-        double sinhArg = vout / nVT;
-        double sinhVal = std::sinh(sinhArg);
-        double coshVal = std::cosh(sinhArg);
+    int iterations = 0;
+    while (iterations < mMaxIter) {
+        ++iterations;
 
-        // f(Vout) = Vout + Rf * 2 * Is * sinh(Vout / (n * VT)) - Vin * Gain
-        double f = vout + twoIsRf * sinhVal - target;
+        double sinhVal, coshVal;
+        fastmath::sinhcosh(w, sinhVal, coshVal);   // one exp for both
 
-        // f'(Vout) = 1 + Rf * 2 * Is * cosh(Vout / (n * VT)) / (n * VT)
-        double df = 1.0 + twoIsRf * coshVal / nVT;
+        const double f = w + k * sinhVal - a;
+        const double df = 1.0 + k * coshVal;
 
-        double delta = f / df;
-        delta = std::clamp(delta, -2.0, 2.0);  // Step size limit
-        vout -= delta;
+        // Keep the root bracketed
+        if (f > 0.0) hi = w;
+        else         lo = w;
 
-        // Check convergence
-        if (std::abs(delta) < TOLERANCE) {
+        // Halley: f·f' / (f'² - f·f''/2) with f'' = k·sinh(w)
+        const double delta = (mStep == Step::Halley) ? f * df / (df * df - 0.5 * f * k * sinhVal)
+                                                     : f / df;
+        if (std::abs(delta) < tolerance) {
+            w -= delta;
             break;
         }
+
+        w -= delta;
+        if (!(w > lo && w < hi))
+            w = 0.5 * (lo + hi);   // damped: bisect instead of leaving the bracket
     }
 
+    mStats.solves++;
+    mStats.iterations += iterations;
+    mStats.maxIterations = std::max(mStats.maxIterations, iterations);
+
+    double vout = sign * w * nVT;
+
     // NaN/Inf safety guard
     if (std::isnan(vout) || std::isinf(vout)) {
-        vout = 0.0;
-        mPrevOutput = 0.0;
-        return vout;
+        mPrevOutput = mPrevOutput2 = 0.0;
+        return 0.0;
     }
 
     // Output clamp (diode forward voltage limit)
     vout = std::clamp(vout, -10.0, 10.0);
+    mPrevOutput2 = mPrevOutput;
     mPrevOutput = vout;
     return vout;
 }
@@ -0,0 +1,161 @@
+#include "DSP/DiodeTransferTable.h"
+#include "DSP/FastMath.h"
+#include "DSP/SharedTables.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+double DiodeTransferTable::nodeU(int j) {
+    const int octave = MIN_OCTAVE + j / NODES_PER_OCTAVE;
+    const int step = j % NODES_PER_OCTAVE;
+    return std::ldexp(1.0 + static_cast<double>(step) / NODES_PER_OCTAVE, octave);
+}
+
+double DiodeTransferTable::solveExact(double u, double k) {
+    if (u == 0.0) return 0.0;
+    const double a = std::abs(u);
+
+    // f(w) = w + k·sinh(w) - a is increasing and convex for w > 0, so Newton
+    // started from an upper bound converges monotonically from above.
+    // Both a and asinh(a/k) are upper bounds of the root.
+    double w = std::min(a, std::asinh(a / k));
+    for (int i = 0; i < 100; ++i) {
+        double f = w + k * std::sinh(w) - a;
+        double df = 1.0 + k * std::cosh(w);
+        double delta = f / df;
+        w -= delta;
+        if (std::abs(delta) <= 1e-15 * std::max(1.0, w)) break;
+    }
+    return std::copysign(w, u);
+}
+
+double DiodeTransferTable::solveOmega(double u, double k, double logHalfK) {
+    // With the e^-w half of sinh dropped, w + (k/2)·e^w = a has the closed form
+    //   w = a - ω(a + ln(k/2))
+    // (substitute z = a - w: z + ln z = a + ln(k/2)). The dropped term is at
+    // most k/2 in size and only matters near w = 0; one Halley step on the
+    // full equation removes it and cubes the error of the fast ω.
+    const double a = std::abs(u);
+    double w = a - fastmath::omega(a + logHalfK);
+
+    double sinhVal, coshVal;
+    fastmath::sinhcosh(w, sinhVal, coshVal);
+    const double f = w + k * sinhVal - a;
+    const double df = 1.0 + k * coshVal;
+    w -= f * df / (df * df - 0.5 * f * k * sinhVal);
+
+    return std::copysign(w, u);
+}
+
+std::shared_ptr<const DiodeTransferTable::Future> DiodeTransferTable::getSharedAsync()
+{
+    return getSharedAsync("diode-transfer", [] { return std::make_shared<const DiodeTransferTable>(); });
+}
+
+std::shared_ptr<const DiodeTransferTable::Future> DiodeTransferTable::getSharedAsync(const std::string& kind, Future::Build build)
+{
+    return SharedTables::getAsync<DiodeTransferTable>({ kind }, std::move(build));
+}
+
+std::shared_ptr<const DiodeTransferTable> DiodeTransferTable::getShared()
+{
+    return getSharedAsync()->wait();
+}
+
+DiodeTransferTable::DiodeTransferTable()
+    : mStorage(static_cast<size_t>(NUM_VALUES))
+{
+    double* w = mStorage.data();
+    double* dw = w + NUM_ROWS * NUM_NODES;
+    for (int row = 0; row < NUM_ROWS; ++row) {
+        const double k = std::pow(10.0, MIN_LOG10_K + static_cast<double>(row) / ROWS_PER_DECADE);
+        for (int j = 0; j < NUM_NODES; ++j) {
+            const int idx = row * NUM_NODES + j;
+            w[idx] = solveExact(nodeU(j), k);
+            dw[idx] = 1.0 / (1.0 + k * std::cosh(w[idx]));  // implicit derivative dw/du
+        }
+    }
+    mW = w;
+    mDw = dw;
+}
+
+DiodeTransferTable::DiodeTransferTable(const double* data, std::shared_ptr<const void> keepAlive)
+    : mKeepAlive(std::move(keepAlive)),
+      mW(data),
+      mDw(data + NUM_ROWS * NUM_NODES)
+{
+}
+
+bool DiodeTransferTable::makeCurve(double k, Curve& curve) const {
+    if (!(k > 0.0)) return false;
+
+    // The outermost rows only serve as Catmull-Rom neighbours
+    const double x = (std::log10(k) - MIN_LOG10_K) * ROWS_PER_DECADE;
+    if (x < 1.0 || x > NUM_ROWS - 2) return false;
+
+    const int r = std::min(static_cast<int>(x), NUM_ROWS - 3);
+    const double t = x - r;
+
+    // Catmull-Rom weights for rows r-1 … r+2
+    const double t2 = t * t, t3 = t2 * t;
+    const double weights[4] = {
+        0.5 * (-t3 + 2.0 * t2 - t),
+        0.5 * (3.0 * t3 - 5.0 * t2 + 2.0),
+        0.5 * (-3.0 * t3 + 4.0 * t2 + t),
+        0.5 * (t3 - t2),
+    };
+    const double* w[4];
+    const double* dw[4];
+    for (int i = 0; i < 4; ++i) {
+        const int row = r - 1 + i;
+        w[i] = mW + row * NUM_NODES;
+        dw[i] = mDw + row * NUM_NODES;
+    }
+
+    for (int j = 0; j < NUM_NODES; ++j) {
+        curve.w[static_cast<size_t>(j)] = weights[0] * w[0][j] + weights[1] * w[1][j]
+                                        + weights[2] * w[2][j] + weights[3] * w[3][j];
+        curve.dw[static_cast<size_t>(j)] = weights[0] * dw[0][j] + weights[1] * dw[1][j]
+                                         + weights[2] * dw[2][j] + weights[3] * dw[3][j];
+    }
+    curve.k = k;
+    return true;
+}
+
+double DiodeTransferTable::Curve::eval(double u) const {
+    const double a = std::abs(u);
+    constexpr double minU = 1.0 / (1 << -MIN_OCTAVE);
+
+    if (a < minU) {
+        // Small-signal region: w ≈ u/(1+k) with the cubic sinh correction
+        const double w1 = a / (1.0 + k);
+        return std::copysign(w1 - k * w1 * w1 * w1 / (6.0 * (1.0 + k)), u);
+    }
+
+    // Split a = 2^e · (1 + m) straight from the IEEE-754 bits
+    std::uint64_t bits;
+    std::memcpy(&bits, &a, sizeof(bits));
+    const int e = static_cast<int>(bits >> 52) - 1023;
+    if (e >= MAX_OCTAVE) return std::numeric_limits<double>::quiet_NaN();
+
+    const double m = static_cast<double>(bits & 0x000FFFFFFFFFFFFFull) * (1.0 / 4503599627370496.0); // 2^-52
+    const double pos = m * NODES_PER_OCTAVE;
+    const int seg = static_cast<int>(pos);
+    static_assert(NODES_PER_OCTAVE == 32, "spacing below assumes 32 nodes per octave");
+    const double t = pos - seg;
+    const size_t j = static_cast<size_t>((e - MIN_OCTAVE) * NODES_PER_OCTAVE + seg);
+    // Node spacing in this octave, 2^e / NODES_PER_OCTAVE (NODES_PER_OCTAVE = 2^5)
+    const std::uint64_t hBits = static_cast<std::uint64_t>(e + 1023 - 5) << 52;
+    double h;
+    std::memcpy(&h, &hBits, sizeof(h));
+
+    // Cubic Hermite with the stored analytic slopes
+    const double t2 = t * t, t3 = t2 * t;
+    const double y = (2.0 * t3 - 3.0 * t2 + 1.0) * w[j]
+                   + (t3 - 2.0 * t2 + t) * h * dw[j]
+                   + (-2.0 * t3 + 3.0 * t2) * w[j + 1]
+                   + (t3 - t2) * h * dw[j + 1];
+    return std::copysign(y, u);
+}
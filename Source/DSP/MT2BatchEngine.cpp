@@ -0,0 +1,214 @@
+#include "DSP/MT2BatchEngine.h"
+#include "DSP/DiodeMorpher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+    // The plugin's render profile (see MT2Plugin): at least 4x
+    constexpr int kRenderMinOsFactorLog2 = 2;
+
+    // NaN (and anything out of range) lands inside the range, so that the
+    // sort in start() sees a strict weak order
+    float clampUnit(float x) { return x > 0.0f ? (x < 1.0f ? x : 1.0f) : 0.0f; }
+
+    // Flush denormals to zero while processing (juce::ScopedNoDenormals does
+    // this for the plugin): decaying tails would otherwise slow down a lot
+    class ScopedFlushDenormals {
+    public:
+#if MT2_SIMD_SSE2
+        ScopedFlushDenormals() : mSaved(_mm_getcsr()) { _mm_setcsr(mSaved | 0x8040); }   // FTZ | DAZ
+        ~ScopedFlushDenormals() { _mm_setcsr(mSaved); }
+    private:
+        unsigned int mSaved;
+#elif MT2_SIMD_NEON && (defined(__GNUC__) || defined(__clang__))
+        ScopedFlushDenormals() {
+            asm volatile("mrs %0, fpcr" : "=r"(mSaved));
+            asm volatile("msr fpcr, %0" : : "r"(mSaved | (std::uint64_t(1) << 24)));   // FZ
+        }
+        ~ScopedFlushDenormals() { asm volatile("msr fpcr, %0" : : "r"(mSaved)); }
+    private:
+        std::uint64_t mSaved;
+#else
+        ScopedFlushDenormals() {}
+#endif
+    };
+
+    // What reaches the DSP: settings that have no effect (stage 2 while
+    // linked, the circuit model outside Diode mode …) do not split groups
+    MT2StreamParams effective(MT2StreamParams p) {
+        if (p.diodeLink) p.diodeMorph2 = p.diodeMorph;
+        p.diodeLink = 1;
+        if (p.clipMode != 0) p.circuitModel = 0;
+        if (p.clipMode == 0) p.clipAntialiasing = 0;
+        if (p.satPosition == 2) p.satAmount = 0.0f;
+        return p;
+    }
+
+    auto settingsKey(const MT2StreamParams& params) {
+        const auto p = effective(params);
+        return std::make_tuple(p.dist, p.diodeMorph, p.diodeMorph2, p.clipMode, p.clipAntialiasing, p.circuitModel,
+                               p.diodeSolver, p.solverQuality, p.eqLow, p.eqMid, p.eqMidFreq, p.eqMidQ, p.eqHigh,
+                               p.satAmount, p.satPosition);
+    }
+}
+
+MT2BatchEngine::MT2BatchEngine(const MT2BatchConfig& config)
+    : mConfig(config)
+{
+    if (config.numStreams < 0 || !(config.sampleRate > 0.0) || config.maxBlockSize <= 0
+        || config.oversamplingFactorLog2 < 0 || config.oversamplingFactorLog2 > Oversampler<double>::MAX_STAGES)
+        throw std::invalid_argument("MT2BatchEngine: bad config");
+
+    if (mConfig.renderProfile)
+        mConfig.oversamplingFactorLog2 = std::max(mConfig.oversamplingFactorLog2, kRenderMinOsFactorLog2);
+
+    MT2StreamParams defaults;
+    mt2_stream_params_init(&defaults);
+    mParams.assign(static_cast<size_t>(config.numStreams), defaults);
+
+    // Set before prepare, so no stream starts on the exact solver while a
+    // background build runs: the output does not depend on timing
+    mDiodeTable = DiodeTransferTable::getShared();
+}
+
+void MT2BatchEngine::setStreamParams(int stream, const MT2StreamParams& params) {
+    auto p = params;
+    p.dist = clampUnit(p.dist);
+    p.diodeMorph = clampUnit(p.diodeMorph);
+    p.diodeMorph2 = clampUnit(p.diodeMorph2);
+    p.eqLow = clampUnit(p.eqLow);
+    p.eqMid = clampUnit(p.eqMid);
+    p.eqMidFreq = clampUnit(p.eqMidFreq);
+    p.eqMidQ = clampUnit(p.eqMidQ);
+    p.eqHigh = clampUnit(p.eqHigh);
+    p.satAmount = clampUnit(p.satAmount);
+    p.diodeLink = p.diodeLink != 0;
+    p.clipAntialiasing = p.clipAntialiasing != 0;
+    p.circuitModel = p.circuitModel != 0;
+    p.clipMode = std::clamp(p.clipMode, 0, 5);
+    p.diodeSolver = std::clamp(p.diodeSolver, 0, 2);
+    p.solverQuality = std::clamp(p.solverQuality, 0, 2);
+    p.satPosition = std::clamp(p.satPosition, 0, 2);
+    mParams[static_cast<size_t>(stream)] = p;
+}
+
+void MT2BatchEngine::start() {
+    mQuads.clear();
+    mPairs.clear();
+    mSingles.clear();
+
+    // Streams with equal settings next to each other, in stream order
+    std::vector<int> order(mParams.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return settingsKey(mParams[static_cast<size_t>(a)]) < settingsKey(mParams[static_cast<size_t>(b)]);
+    });
+
+    for (size_t first = 0; first < order.size();) {
+        const auto key = settingsKey(mParams[static_cast<size_t>(order[first])]);
+        size_t last = first + 1;
+        while (last < order.size() && settingsKey(mParams[static_cast<size_t>(order[last])]) == key)
+            ++last;
+
+        // Like the plugin's channel groups: quads, then a pair, then a single
+        size_t pos = first;
+        for (; last - pos >= 4; pos += 4)
+            addGroup(mQuads, order.data() + pos);
+        if (last - pos >= 2) {
+            addGroup(mPairs, order.data() + pos);
+            pos += 2;
+        }
+        if (pos < last)
+            addGroup(mSingles, order.data() + pos);
+        first = last;
+    }
+
+    // Every group runs the same oversampling
+    mLatencySamples = 0;
+    if (!mQuads.empty())        mLatencySamples = mQuads.front()->chain.getOversampler().getLatencySamples();
+    else if (!mPairs.empty())   mLatencySamples = mPairs.front()->chain.getOversampler().getLatencySamples();
+    else if (!mSingles.empty()) mLatencySamples = mSingles.front()->chain.getOversampler().getLatencySamples();
+    mStarted = true;
+}
+
+template <typename SampleType>
+void MT2BatchEngine::addGroup(std::vector<std::unique_ptr<Group<SampleType>>>& groups, const int* streams) {
+    auto group = std::make_unique<Group<SampleType>>();
+    std::copy_n(streams, Group<SampleType>::numLanes, group->streams.begin());
+    configure(*group, effective(mParams[static_cast<size_t>(streams[0])]));
+    groups.push_back(std::move(group));
+}
+
+template <typename SampleType>
+void MT2BatchEngine::configure(Group<SampleType>& group, const MT2StreamParams& p) {
+    auto& chain = group.chain;
+    auto& gainStage = chain.getGainStage();
+
+    gainStage.setDiodeTable(mDiodeTable);
+    chain.setOversamplingQuality(mConfig.renderProfile != 0);
+    chain.prepare(mConfig.sampleRate, mConfig.maxBlockSize);
+    chain.setOversampling(mConfig.oversamplingFactorLog2, mConfig.minimumPhase != 0);
+
+    // As MT2Plugin applies its parameters (see ParameterSnapshot)
+    const DiodeMorpher morpher;
+    const auto stage1 = morpher.getMorphedParams(p.diodeMorph);
+    const auto stage2 = morpher.getMorphedParams(p.diodeMorph2);
+    gainStage.setGain(MT2GainStage<SampleType>::gainForDist(p.dist));
+    gainStage.setStage1Diode(stage1.is, stage1.n, stage1.noClip);
+    gainStage.setStage2Diode(stage2.is, stage2.n, stage2.noClip);
+    gainStage.setClipMode(p.clipMode);
+    gainStage.setAntialiasing(p.clipAntialiasing != 0);
+    using Engine = typename MT2GainStage<SampleType>::Engine;
+    gainStage.setEngine(p.circuitModel ? Engine::Circuit : Engine::Classic);
+
+    if (mConfig.renderProfile) {
+        gainStage.setDiodeSolver(DiodeFeedbackClipper::Solver::Newton);
+        gainStage.setDiodeQuality(DiodeFeedbackClipper::Quality::High);
+    } else {
+        gainStage.setDiodeSolver(static_cast<DiodeFeedbackClipper::Solver>(p.diodeSolver));
+        gainStage.setDiodeQuality(static_cast<DiodeFeedbackClipper::Quality>(p.solverQuality));
+    }
+
+    chain.getToneStack().updateCoefficients(p.eqLow, p.eqMid, p.eqMidFreq, p.eqMidQ, p.eqHigh);
+
+    group.preSat = MT2Saturator(p.satPosition == 0 ? p.satAmount : 0.0f);
+    group.postSat = MT2Saturator(p.satPosition == 1 ? p.satAmount : 0.0f);
+}
+
+template <typename FloatType>
+void MT2BatchEngine::process(const FloatType* const* inputs, FloatType* const* outputs, int numSamples) {
+    ScopedFlushDenormals flushDenormals;
+
+    for (int offset = 0; offset < numSamples; offset += mConfig.maxBlockSize) {
+        const int n = std::min(mConfig.maxBlockSize, numSamples - offset);
+        for (auto& group : mQuads)   processGroup(*group, inputs, outputs, offset, n);
+        for (auto& group : mPairs)   processGroup(*group, inputs, outputs, offset, n);
+        for (auto& group : mSingles) processGroup(*group, inputs, outputs, offset, n);
+    }
+}
+
+template <typename FloatType, typename SampleType>
+void MT2BatchEngine::processGroup(Group<SampleType>& group, const FloatType* const* inputs, FloatType* const* outputs,
+                                  int offset, int numSamples) {
+    constexpr int numLanes = Group<SampleType>::numLanes;
+    const FloatType* in[numLanes];
+    FloatType* out[numLanes];
+    for (int lane = 0; lane < numLanes; ++lane) {
+        const auto stream = static_cast<size_t>(group.streams[static_cast<size_t>(lane)]);
+        in[lane] = inputs[stream] + offset;
+        out[lane] = outputs[stream] + offset;
+    }
+
+    auto& chain = group.chain;
+    chain.pack(in, numLanes, numSamples, group.preSat);
+    chain.processGainStage(numSamples);
+    chain.processToneStack(numSamples);
+    chain.unpack(out, numLanes, numSamples, group.postSat);
+}
+
+template void MT2BatchEngine::process(const float* const*, float* const*, int);
+template void MT2BatchEngine::process(const double* const*, double* const*, int);
@@ -0,0 +1,150 @@
+#include "DSP/MT2ChannelChain.h"
+#include <algorithm>
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::prepare(double sampleRate, int maxBlockSize) {
+    mSampleRate = sampleRate;
+    mMaxBlockSize = maxBlockSize;
+
+    // Switching the factor later re-prepares the gain stage on the audio thread
+    for (int factorLog2 = 0; factorLog2 <= OversamplerType::MAX_STAGES; ++factorLog2)
+        mGainStage.preload(sampleRate * (1 << factorLog2));
+
+    mOversampler.prepare(maxBlockSize);
+    mGainStage.prepare(sampleRate * mOversampler.getFactor());
+    mToneStack.prepare(sampleRate);
+    mLanes.assign(static_cast<size_t>(maxBlockSize), SampleType {});
+    mSameSamples = kLanesAtRest;
+}
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::reset() {
+    mGainStage.reset();
+    mOversampler.reset();
+    mToneStack.reset();
+    mSameSamples = kLanesAtRest;
+}
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::ensureBlockSize(int numSamples) {
+    if (numSamples <= mMaxBlockSize) return;
+    mMaxBlockSize = numSamples;
+    mLanes.resize(static_cast<size_t>(numSamples));
+    mOversampler.prepare(numSamples);
+}
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::setOversampling(int factorLog2, bool minimumPhase) {
+    mOversampler.setConfig(factorLog2, minimumPhase ? OversamplerType::Phase::Minimum : OversamplerType::Phase::Linear);
+    mGainStage.prepare(mSampleRate * mOversampler.getFactor());
+    mSameSamples = kLanesAtRest;   // both were reset
+}
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::setOversamplingQuality(bool render) {
+    mOversampler.setQuality(render ? OversamplerType::Quality::Render : OversamplerType::Quality::Live);
+}
+
+template <typename SampleType>
+template <typename FloatType>
+void MT2ChannelChain<SampleType>::pack(const FloatType* const* channels, int numChannels, int numSamples,
+                                       const MT2Saturator& sat) {
+    double* lanes = simd::flat(mLanes.data());
+    for (int c = 0; c < numLanes; ++c) {
+        double* dest = lanes + c;
+        if (c >= numChannels) {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i * numLanes] = 0.0;
+            continue;
+        }
+        const FloatType* src = channels[c];
+        if (sat.active) {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i * numLanes] = sat(static_cast<double>(src[i]));
+        } else {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i * numLanes] = static_cast<double>(src[i]);
+        }
+    }
+}
+
+template <typename SampleType>
+template <typename FloatType>
+void MT2ChannelChain<SampleType>::updateLinkedLanes(const FloatType* const* channels, int numChannels, int numSamples,
+                                                    int holdSamples) {
+    if (numLanes == 1) return;
+
+    // Stereo content differs within the first few samples, so this is cheap
+    bool same = numChannels == numLanes;
+    for (int c = 1; same && c < numLanes; ++c)
+        same = std::equal(channels[0], channels[0] + numSamples, channels[c]);
+
+    mGainStage.setLinkedLanes(same && mSameSamples >= holdSamples);
+    mSameSamples = same ? std::min(mSameSamples, holdSamples) + numSamples : 0;
+}
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::processGainStage(int numSamples) {
+    SampleType* lanes = mLanes.data();
+    if (mOversampler.getFactor() > 1) {
+        SampleType* os = mOversampler.processUp(lanes, numSamples);
+        mGainStage.process(os, os, numSamples * mOversampler.getFactor());
+        mOversampler.processDown(lanes, numSamples);
+    } else {
+        mGainStage.process(lanes, lanes, numSamples);
+    }
+}
+
+template <typename SampleType>
+void MT2ChannelChain<SampleType>::processToneStack(int numSamples) {
+    mToneStack.process(mLanes.data(), mLanes.data(), numSamples);
+}
+
+template <typename SampleType>
+template <typename FloatType>
+void MT2ChannelChain<SampleType>::unpack(FloatType* const* channels, int numChannels, int numSamples,
+                                         const MT2Saturator& sat) const {
+    const double* lanes = simd::flat(mLanes.data());
+    for (int c = 0; c < std::min(numChannels, numLanes); ++c) {
+        const double* src = lanes + c;
+        FloatType* dest = channels[c];
+        if (sat.active) {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = static_cast<FloatType>(sat(src[i * numLanes]));
+        } else {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = static_cast<FloatType>(src[i * numLanes]);
+        }
+    }
+}
+
+template <typename SampleType>
+double MT2ChannelChain<SampleType>::getPeak(int numSamples) const {
+    const double* samples = simd::flat(mLanes.data());
+    double peak = 0.0;
+    for (int i = 0; i < numSamples * numLanes; ++i)
+        peak = std::max(peak, std::abs(samples[i]));
+    return peak;
+}
+
+template class MT2ChannelChain<double>;
+template class MT2ChannelChain<simd::Double2>;
+template class MT2ChannelChain<simd::Double4>;
+template void MT2ChannelChain<double>::pack(const float* const*, int, int, const MT2Saturator&);
+template void MT2ChannelChain<double>::unpack(float* const*, int, int, const MT2Saturator&) const;
+template void MT2ChannelChain<double>::updateLinkedLanes(const float* const*, int, int, int);
+template void MT2ChannelChain<double>::pack(const double* const*, int, int, const MT2Saturator&);
+template void MT2ChannelChain<double>::unpack(double* const*, int, int, const MT2Saturator&) const;
+template void MT2ChannelChain<double>::updateLinkedLanes(const double* const*, int, int, int);
+template void MT2ChannelChain<simd::Double2>::pack(const float* const*, int, int, const MT2Saturator&);
+template void MT2ChannelChain<simd::Double2>::unpack(float* const*, int, int, const MT2Saturator&) const;
+template void MT2ChannelChain<simd::Double2>::updateLinkedLanes(const float* const*, int, int, int);
+template void MT2ChannelChain<simd::Double2>::pack(const double* const*, int, int, const MT2Saturator&);
+template void MT2ChannelChain<simd::Double2>::unpack(double* const*, int, int, const MT2Saturator&) const;
+template void MT2ChannelChain<simd::Double2>::updateLinkedLanes(const double* const*, int, int, int);
+template void MT2ChannelChain<simd::Double4>::pack(const float* const*, int, int, const MT2Saturator&);
+template void MT2ChannelChain<simd::Double4>::unpack(float* const*, int, int, const MT2Saturator&) const;
+template void MT2ChannelChain<simd::Double4>::updateLinkedLanes(const float* const*, int, int, int);
+template void MT2ChannelChain<simd::Double4>::pack(const double* const*, int, int, const MT2Saturator&);
+template void MT2ChannelChain<simd::Double4>::unpack(double* const*, int, int, const MT2Saturator&) const;
+template void MT2ChannelChain<simd::Double4>::updateLinkedLanes(const double* const*, int, int, int);
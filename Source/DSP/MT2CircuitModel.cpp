@@ -0,0 +1,304 @@
+#include "DSP/MT2CircuitModel.h"
+#include "DSP/DecayTime.h"
+#include "DSP/SharedTables.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    // Nodes (ground is -1), then the extra MNA unknowns
+    enum Node { In, Inv1, Out1, N1, N2, Inv2, Out2, NumNodes };
+    enum Extra { SourceCurrent = NumNodes, OpAmp1Current, OpAmp2Current, NumUnknowns };
+
+    // Component values (see the netlist in MT2CircuitModel.h)
+    constexpr double Rf1 = 10000.0, Ri = Rf1, Cf1 = 100e-12;
+    constexpr double Rl = 330.0, Cl = 190e-9, Cc = 680e-9, R2 = 845.0;
+    constexpr double Rf2 = 4700.0, Cf2 = 220e-12;
+
+    struct Branch { int a, b; };
+    constexpr Branch kCapacitors[] = { { Inv1, Out1 }, { N1, -1 }, { N1, N2 }, { Inv2, Out2 } };
+    constexpr double kCapacitance[] = { Cf1, Cl, Cc, Cf2 };
+    constexpr Branch kPorts[] = { { Inv1, Out1 }, { Inv2, Out2 } };   // current flows a → b for v_ab > 0
+
+    constexpr int NUM_STATES = MT2CircuitStateSpace::NUM_STATES;
+    constexpr int NUM_PORTS = MT2CircuitStateSpace::NUM_PORTS;
+    constexpr int N = NumUnknowns;
+    using Matrix = std::array<std::array<double, N>, N>;
+    using Vector = std::array<double, N>;
+
+    void stampConductance(Matrix& m, Branch br, double g) {
+        if (br.a >= 0) m[br.a][br.a] += g;
+        if (br.b >= 0) m[br.b][br.b] += g;
+        if (br.a >= 0 && br.b >= 0) {
+            m[br.a][br.b] -= g;
+            m[br.b][br.a] -= g;
+        }
+    }
+
+    // Current source of 1 A flowing a → b through the element
+    Vector currentInjection(Branch br) {
+        Vector v {};
+        if (br.a >= 0) v[br.a] -= 1.0;
+        if (br.b >= 0) v[br.b] += 1.0;
+        return v;
+    }
+
+    double branchVoltage(const Vector& z, Branch br) {
+        return (br.a >= 0 ? z[br.a] : 0.0) - (br.b >= 0 ? z[br.b] : 0.0);
+    }
+
+    // Solves m·x = rhs for every column of rhs (Gauss-Jordan, partial pivoting)
+    template <size_t Cols>
+    std::array<Vector, Cols> solve(Matrix m, std::array<Vector, Cols> rhs) {
+        for (int col = 0; col < N; ++col) {
+            int pivot = col;
+            for (int r = col + 1; r < N; ++r)
+                if (std::abs(m[r][col]) > std::abs(m[pivot][col])) pivot = r;
+            std::swap(m[col], m[pivot]);
+            for (auto& v : rhs) std::swap(v[col], v[pivot]);
+
+            const double inv = 1.0 / m[col][col];
+            for (int r = 0; r < N; ++r) {
+                if (r == col || m[r][col] == 0.0) continue;
+                const double f = m[r][col] * inv;
+                for (int c = col; c < N; ++c) m[r][c] -= f * m[col][c];
+                for (auto& v : rhs) v[r] -= f * v[col];
+            }
+        }
+        for (auto& v : rhs)
+            for (int r = 0; r < N; ++r) v[r] /= m[r][r];
+        return rhs;
+    }
+
+    // Spectral radius by repeated squaring: ρ = lim ‖A^m‖^(1/m)
+    template <typename Square>
+    double computeSpectralRadius(Square a) {
+        constexpr int size = static_cast<int>(std::tuple_size<Square>::value);
+        double logScale = 0.0;
+        for (int iter = 0; iter < 24; ++iter) {
+            Square sq {};
+            for (int r = 0; r < size; ++r)
+                for (int c = 0; c < size; ++c)
+                    for (int k = 0; k < size; ++k) sq[r][c] += a[r][k] * a[k][c];
+
+            double norm = 0.0;
+            for (const auto& row : sq)
+                for (double v : row) norm = std::max(norm, std::abs(v));
+            if (norm == 0.0) return 0.0;
+            for (auto& row : sq)
+                for (double& v : row) v /= norm;
+
+            logScale = 2.0 * logScale + std::log(norm);
+            a = sq;
+        }
+        return std::exp(logScale / 16777216.0);   // 2^24
+    }
+}
+
+MT2CircuitStateSpace::MT2CircuitStateSpace(double rate) : sampleRate(rate) {
+    // MNA matrix with the capacitors replaced by their trapezoidal companions
+    // (conductance 2C·fs in parallel with a history current source)
+    Matrix m {};
+    stampConductance(m, { In, Inv1 }, 1.0 / Ri);
+    stampConductance(m, { Inv1, Out1 }, 1.0 / Rf1);
+    stampConductance(m, { Out1, N1 }, 1.0 / Rl);
+    stampConductance(m, { N2, Inv2 }, 1.0 / R2);
+    stampConductance(m, { Inv2, Out2 }, 1.0 / Rf2);
+
+    std::array<double, NUM_STATES> g {};
+    for (int s = 0; s < NUM_STATES; ++s) {
+        g[s] = 2.0 * kCapacitance[s] * sampleRate;
+        stampConductance(m, kCapacitors[s], g[s]);
+    }
+
+    // Input voltage source at In; ideal op-amps hold inv at 0 V and supply
+    // whatever output current that takes
+    m[In][SourceCurrent] = 1.0;
+    m[SourceCurrent][In] = 1.0;
+    m[Out1][OpAmp1Current] = 1.0;
+    m[OpAmp1Current][Inv1] = 1.0;
+    m[Out2][OpAmp2Current] = 1.0;
+    m[OpAmp2Current][Inv2] = 1.0;
+
+    // Responses to each state (history current), the input and each port current
+    std::array<Vector, NUM_STATES + 1 + NUM_PORTS> rhs {};
+    for (int s = 0; s < NUM_STATES; ++s) {
+        rhs[s] = currentInjection(kCapacitors[s]);
+        for (double& v : rhs[s]) v = -v;   // the history source drives current b → a
+    }
+    rhs[NUM_STATES][SourceCurrent] = 1.0;
+    for (int p = 0; p < NUM_PORTS; ++p)
+        rhs[NUM_STATES + 1 + p] = currentInjection(kPorts[p]);
+
+    const auto z = solve(m, rhs);
+    const auto& zu = z[NUM_STATES];
+
+    // x[n] = 2g·v_C[n] - x[n-1];  v_port = D·x + E·u + K·i;  y = v(Out2)
+    for (int s = 0; s < NUM_STATES; ++s) {
+        for (int c = 0; c < NUM_STATES; ++c)
+            A[s][c] = 2.0 * g[s] * branchVoltage(z[c], kCapacitors[s]) - (s == c ? 1.0 : 0.0);
+        B[s] = 2.0 * g[s] * branchVoltage(zu, kCapacitors[s]);
+        for (int p = 0; p < NUM_PORTS; ++p)
+            C[s][p] = 2.0 * g[s] * branchVoltage(z[NUM_STATES + 1 + p], kCapacitors[s]);
+    }
+    for (int p = 0; p < NUM_PORTS; ++p) {
+        for (int c = 0; c < NUM_STATES; ++c)
+            D[p][c] = branchVoltage(z[c], kPorts[p]);
+        E[p] = branchVoltage(zu, kPorts[p]);
+        for (int q = 0; q < NUM_PORTS; ++q)
+            K[p][q] = branchVoltage(z[NUM_STATES + 1 + q], kPorts[p]);
+    }
+    for (int c = 0; c < NUM_STATES; ++c)
+        G[c] = z[c][Out2];
+    H = zu[Out2];
+    for (int p = 0; p < NUM_PORTS; ++p)
+        L[p] = z[NUM_STATES + 1 + p][Out2];
+
+    spectralRadius = computeSpectralRadius(A);
+}
+
+std::shared_ptr<const MT2CircuitStateSpace> MT2CircuitStateSpace::getShared(double sampleRate) {
+    return SharedTables::get<MT2CircuitStateSpace>({ "mt2-circuit", sampleRate }, [sampleRate] {
+        return std::make_shared<const MT2CircuitStateSpace>(sampleRate);
+    });
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::preload(double sampleRate) {
+    for (const auto& stateSpace : mPreloaded)
+        if (stateSpace != nullptr && stateSpace->sampleRate == sampleRate) return;
+
+    std::rotate(mPreloaded.rbegin(), mPreloaded.rbegin() + 1, mPreloaded.rend());
+    mPreloaded[0] = MT2CircuitStateSpace::getShared(sampleRate);
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::prepare(double sampleRate) {
+    preload(sampleRate);
+    for (const auto& stateSpace : mPreloaded)
+        if (stateSpace != nullptr && stateSpace->sampleRate == sampleRate) mStateSpace = stateSpace;
+
+    for (int p = 0; p < NUM_PORTS; ++p)
+        updatePort(p);
+    reset();
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::reset() {
+    for (auto& x : mX) x.fill(0.0);
+}
+
+template <typename SampleType>
+double MT2CircuitModel<SampleType>::getTailSamples(double decayDb) const {
+    return mStateSpace != nullptr ? decaySamples(mStateSpace->spectralRadius, decayDb) : 0.0;
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::setDiodeTable(const DiodeTransferTable* table) {
+    mTable = table;
+    for (auto& port : mPorts) port.curveValid = false;
+    for (int p = 0; p < NUM_PORTS; ++p)
+        updatePort(p);
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::setDiode(int index, double is, double n, bool noClip) {
+    auto& port = mPorts[static_cast<size_t>(index)];
+    if (is == port.is && n == port.n && noClip == port.noClip && port.nVT > 0.0)
+        return;
+    port.is = is;
+    port.n = n;
+    port.noClip = noClip;
+    updatePort(index);
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::updatePort(int index) {
+    auto& port = mPorts[static_cast<size_t>(index)];
+    if (mStateSpace == nullptr) return;   // before prepare()
+    const double resistance = -mStateSpace->K[static_cast<size_t>(index)][static_cast<size_t>(index)];
+
+    port.nVT = port.n * VT;
+    port.invNVT = 1.0 / port.nVT;
+    const double k = 2.0 * port.is * resistance / port.nVT;
+    port.logHalfK = std::log(0.5 * k);
+
+    // Only re-blend on change (the blend walks the whole curve)
+    if (port.curveValid && k == port.k) return;
+    port.k = k;
+    port.curveValid = mTable != nullptr && mTable->makeCurve(k, port.curve);
+}
+
+template <typename SampleType>
+double MT2CircuitModel<SampleType>::solvePort(const Port& port, double p) const {
+    const double u = p * port.invNVT;
+    double w = port.curveValid ? port.curve.eval(u) : u;
+    if (!port.curveValid || std::isnan(w))
+        w = DiodeTransferTable::solveOmega(u, port.k, port.logHalfK);
+    return w * port.nVT;
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::process(const SampleType* in, SampleType* out, int numSamples) {
+    const double* inFlat = simd::flat(in);
+    double* outFlat = simd::flat(out);
+
+    const MT2CircuitStateSpace& ss = *mStateSpace;
+    const Port& port1 = mPorts[0];
+    const Port& port2 = mPorts[1];
+    const double drive = port1.noClip ? 1.0 : mGain;
+    const double outputScale = port2.noClip ? 0.25 : 1.0;
+    const double invK11 = 1.0 / ss.K[0][0], invK22 = 1.0 / ss.K[1][1], k21 = ss.K[1][0];
+
+    // Lanes inside the sample loop: the recursion through the states is
+    // serial, so independent lanes are what the CPU can overlap
+    const int activeLanes = mLinked ? 1 : numLanes;
+    auto x = mX;
+    for (int n = 0; n < numSamples; ++n) {
+        for (int lane = 0; lane < activeLanes; ++lane) {
+            auto& xl = x[static_cast<size_t>(lane)];
+            const size_t idx = static_cast<size_t>(n * numLanes + lane);
+            const double u = inFlat[idx] * drive;
+
+            // Port 1 (stage 1 diodes), then port 2 with stage 1's current fed through
+            double p1 = ss.E[0] * u, p2 = ss.E[1] * u;
+            for (size_t c = 0; c < NUM_STATES; ++c) {
+                p1 += ss.D[0][c] * xl[c];
+                p2 += ss.D[1][c] * xl[c];
+            }
+            const double i1 = port1.noClip ? 0.0 : (solvePort(port1, p1) - p1) * invK11;
+            p2 += k21 * i1;
+            const double i2 = port2.noClip ? 0.0 : (solvePort(port2, p2) - p2) * invK22;
+
+            double y = ss.H * u + ss.L[0] * i1 + ss.L[1] * i2;
+            for (size_t c = 0; c < NUM_STATES; ++c)
+                y += ss.G[c] * xl[c];
+
+            std::array<double, NUM_STATES> next;
+            for (size_t s = 0; s < NUM_STATES; ++s) {
+                double v = ss.B[s] * u + ss.C[s][0] * i1 + ss.C[s][1] * i2;
+                for (size_t c = 0; c < NUM_STATES; ++c)
+                    v += ss.A[s][c] * xl[c];
+                next[s] = v;
+            }
+            xl = next;
+
+            outFlat[idx] = y * outputScale;
+        }
+    }
+    mX = x;
+
+    if (mLinked)
+        simd::copyFirstLane(out, numSamples);
+}
+
+template <typename SampleType>
+void MT2CircuitModel<SampleType>::setLinkedLanes(bool linked) {
+    if (mLinked && !linked)
+        std::fill(mX.begin() + 1, mX.end(), mX[0]);
+    mLinked = linked;
+}
+
+template class MT2CircuitModel<double>;
+template class MT2CircuitModel<simd::Double2>;
+template class MT2CircuitModel<simd::Double4>;
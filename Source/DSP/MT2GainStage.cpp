@@ -1,88 +1,374 @@
 #include "DSP/MT2GainStage.h"
+#include "DSP/FastMath.h"
 #include <cmath>
 #include <algorithm>
 
-MT2GainStage::MT2GainStage()
-    : mInterstageHPF(OnePoleFilter::Type::HPF)
-    , mInterstageLPF(OnePoleFilter::Type::LPF)
+namespace {
+    // Asymmetric clip: tanh(x) above zero, tanh(x/2) below. The slope is
+    // picked arithmetically so the loop stays branch-free and vectorises.
+    inline double asymmetricTanh(double x) {
+        return fastmath::tanh(x * (0.5 + 0.5 * fastmath::detail::step(x, 0.0)));
+    }
+
+    // Static waveshaper over a block; the mode switch sits outside the loops,
+    // which are branch-free (fastmath) so the compiler vectorises them
+    void clipBlock(const double* in, double* out, int numSamples, double gain, int mode) {
+        switch (mode) {
+        case 2:
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = (2.0 / M_PI) * fastmath::atan(in[i] * gain);
+            break;
+        case 3:
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = std::clamp(in[i] * gain, -1.0, 1.0);
+            break;
+        case 4:
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = asymmetricTanh(in[i] * gain);
+            break;
+        case 5:
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = fastmath::sin(in[i] * gain);
+            break;
+        default:
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = fastmath::tanh(in[i] * gain);
+            break;
+        }
+    }
+
+    // log(cosh(x)) without overflow: |x| + log(1 + e^-2|x|) - log 2
+    inline double logCosh(double x) {
+        const double a = std::abs(x);
+        return a + std::log1p(std::exp(-2.0 * a)) - M_LN2;
+    }
+
+    // First-order ADAA over one lane: y = (F(x) - F(x1)) / (x - x1), falling
+    // back to f at the midpoint when x and x1 are too close for the division
+    // to be accurate (the error of either branch is then below 1e-9).
+    template <typename Curve, typename Antiderivative>
+    void adaaLoop(const double* in, double* out, int numSamples, int stride, double gain,
+                  double& prevX, double& prevF, bool restart, Curve f, Antiderivative F) {
+        constexpr double kIllConditioned = 1e-5;
+        if (restart && numSamples > 0) {
+            prevX = in[0] * gain;
+            prevF = F(prevX);
+        }
+
+        double x1 = prevX;
+        double F1 = prevF;
+        for (int i = 0; i < numSamples * stride; i += stride) {
+            const double x = in[i] * gain;
+            const double Fx = F(x);
+            const double dx = x - x1;
+            out[i] = std::abs(dx) < kIllConditioned ? f(0.5 * (x + x1)) : (Fx - F1) / dx;
+            x1 = x;
+            F1 = Fx;
+        }
+        prevX = x1;
+        prevF = F1;
+    }
+
+    // Static waveshaper with antiderivative anti-aliasing; the mode switch
+    // sits outside the loops. Antiderivatives are all 0 at x = 0. They stay
+    // on libm: the difference quotient scales their error by up to 1e5.
+    void clipBlockADAA(const double* in, double* out, int numSamples, int stride, double gain, int mode,
+                       double& prevX, double& prevF, bool restart) {
+        switch (mode) {
+        case 2:
+            adaaLoop(in, out, numSamples, stride, gain, prevX, prevF, restart,
+                     [](double x) { return (2.0 / M_PI) * fastmath::atan(x); },
+                     [](double x) { return (2.0 / M_PI) * (x * std::atan(x) - 0.5 * std::log1p(x * x)); });
+            break;
+        case 3:
+            adaaLoop(in, out, numSamples, stride, gain, prevX, prevF, restart,
+                     [](double x) { return std::clamp(x, -1.0, 1.0); },
+                     [](double x) { return std::abs(x) <= 1.0 ? 0.5 * x * x : std::abs(x) - 0.5; });
+            break;
+        case 4:
+            adaaLoop(in, out, numSamples, stride, gain, prevX, prevF, restart,
+                     [](double x) { return asymmetricTanh(x); },
+                     [](double x) { return x >= 0.0 ? logCosh(x) : 2.0 * logCosh(x * 0.5); });
+            break;
+        case 5:
+            adaaLoop(in, out, numSamples, stride, gain, prevX, prevF, restart,
+                     [](double x) { return fastmath::sin(x); },
+                     [](double x) { return 1.0 - std::cos(x); });
+            break;
+        default:
+            adaaLoop(in, out, numSamples, stride, gain, prevX, prevF, restart,
+                     [](double x) { return fastmath::tanh(x); },
+                     [](double x) { return logCosh(x); });
+            break;
+        }
+    }
+}
+
+template <typename SampleType>
+MT2GainStage<SampleType>::MT2GainStage()
+    : mInterstageHPF(OnePoleFilter<SampleType>::Type::HPF)
+    , mInterstageLPF(OnePoleFilter<SampleType>::Type::LPF)
 {
 }
 
-void MT2GainStage::prepare(double sampleRate) {
-    mStage1.setSampleRate(sampleRate);
-    mStage2.setSampleRate(sampleRate);
+template <typename SampleType>
+void MT2GainStage<SampleType>::prepare(double sampleRate) {
+    // The table does not depend on the sample rate; every instance in the
+    // process shares one copy. The first instance builds it in the
+    // background instead of holding up prepare().
+    if (mDiodeTable == nullptr && mPendingTable == nullptr)
+        mPendingTable = DiodeTransferTable::getSharedAsync();
+    pollDiodeTable();
 
-    mStage1.setRf(10000.0);
-    mStage2.setRf(4700.0);
+    for (int lane = 0; lane < numLanes; ++lane) {
+        auto& stage1 = mStage1[static_cast<size_t>(lane)];
+        auto& stage2 = mStage2[static_cast<size_t>(lane)];
 
-    mStage2.setGain(4.0);
+        stage1.setSampleRate(sampleRate);
+        stage2.setSampleRate(sampleRate);
+
+        stage1.setRf(10000.0);
+        stage2.setRf(4700.0);
+
+        stage2.setGain(4.0);
+    }
 
     mInterstageHPF.setCutoffFrequency(200.0, sampleRate);
     mInterstageLPF.setCutoffFrequency(3500.0, sampleRate);
 
+    mCircuit.prepare(sampleRate);
+
     reset();
 }
 
-void MT2GainStage::reset() {
-    mStage1.reset();
-    mStage2.reset();
+template <typename SampleType>
+void MT2GainStage<SampleType>::reset() {
+    for (auto& stage : mStage1) stage.reset();
+    for (auto& stage : mStage2) stage.reset();
     mInterstageHPF.reset();
     mInterstageLPF.reset();
+    mCircuit.reset();
+    mAdaaRestart = true;
+}
+
+template <typename SampleType>
+double MT2GainStage<SampleType>::getTailSamples(double decayDb) const {
+    return std::max(mInterstageHPF.getTailSamples(decayDb) + mInterstageLPF.getTailSamples(decayDb),
+                    mCircuit.getTailSamples(decayDb));
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setGain(double gain) {
+    for (auto& stage : mStage1) stage.setGain(gain);
+    mCircuit.setGain(gain);
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setStage1Diode(double is, double n, bool noClip) {
+    for (auto& stage : mStage1) {
+        stage.setDiodeParams(is, n);
+        stage.setBypass(noClip);
+    }
+    mCircuit.setStage1Diode(is, n, noClip);
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setStage2Diode(double is, double n, bool noClip) {
+    for (auto& stage : mStage2) {
+        stage.setDiodeParams(is, n);
+        stage.setBypass(noClip);
+    }
+    mCircuit.setStage2Diode(is, n, noClip);
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setClipMode(int mode) {
+    mode = std::clamp(mode, 0, 5);
+    if (mode != mClipMode)
+        mAdaaRestart = true;
+    mClipMode = mode;
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setEngine(Engine engine) {
+    if (engine == mEngine) return;
+    mEngine = engine;
+
+    // The engine coming in has been idle: start it from rest
+    if (engine == Engine::Circuit) {
+        mCircuit.reset();
+    } else {
+        for (auto& stage : mStage1) stage.reset();
+        for (auto& stage : mStage2) stage.reset();
+        mInterstageHPF.reset();
+        mInterstageLPF.reset();
+    }
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setAntialiasing(bool enabled) {
+    if (enabled != mAntialiasing)
+        mAdaaRestart = true;
+    mAntialiasing = enabled;
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setDiodeTable(std::shared_ptr<const DiodeTransferTable> table) {
+    mPendingTable = nullptr;
+    installDiodeTable(std::move(table));
 }
 
-void MT2GainStage::setGain(double gain) {
-    mStage1.setGain(gain);
+template <typename SampleType>
+void MT2GainStage<SampleType>::setPendingDiodeTable(std::shared_ptr<const DiodeTransferTable::Future> pending) {
+    mPendingTable = std::move(pending);
+    installDiodeTable(nullptr);
+    pollDiodeTable();
 }
 
-void MT2GainStage::setStage1Diode(double is, double n, bool noClip) {
-    mStage1.setDiodeParams(is, n);
-    mStage1.setBypass(noClip);
+template <typename SampleType>
+void MT2GainStage<SampleType>::pollDiodeTable() {
+    // One atomic load per block until the table arrives. The curves it
+    // replaces are exact, so the switch is below -120 dB.
+    if (mDiodeTable == nullptr && mPendingTable != nullptr)
+        if (auto table = mPendingTable->tryGet())
+            installDiodeTable(std::move(table));
 }
 
-void MT2GainStage::setStage2Diode(double is, double n, bool noClip) {
-    mStage2.setDiodeParams(is, n);
-    mStage2.setBypass(noClip);
+template <typename SampleType>
+void MT2GainStage<SampleType>::installDiodeTable(std::shared_ptr<const DiodeTransferTable> table) {
+    mDiodeTable = std::move(table);
+    for (auto& stage : mStage1) stage.setTransferTable(mDiodeTable.get());
+    for (auto& stage : mStage2) stage.setTransferTable(mDiodeTable.get());
+    mCircuit.setDiodeTable(mDiodeTable.get());
 }
 
-void MT2GainStage::setClipMode(int mode) {
-    mClipMode = std::clamp(mode, 0, 5);
+template <typename SampleType>
+void MT2GainStage<SampleType>::setDiodeSolver(DiodeFeedbackClipper::Solver solver) {
+    for (auto& stage : mStage1) stage.setSolver(solver);
+    for (auto& stage : mStage2) stage.setSolver(solver);
 }
 
-double MT2GainStage::applyClip(double x, int mode) {
+template <typename SampleType>
+void MT2GainStage<SampleType>::setDiodeQuality(DiodeFeedbackClipper::Quality quality) {
+    for (auto& stage : mStage1) stage.setQuality(quality);
+    for (auto& stage : mStage2) stage.setQuality(quality);
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setDiodePredictor(DiodeFeedbackClipper::Predictor predictor,
+                                                 DiodeFeedbackClipper::Step step) {
+    for (auto& stage : mStage1) { stage.setPredictor(predictor); stage.setStep(step); }
+    for (auto& stage : mStage2) { stage.setPredictor(predictor); stage.setStep(step); }
+}
+
+template <typename SampleType>
+DiodeFeedbackClipper::IterationStats MT2GainStage<SampleType>::getIterationStats() const {
+    DiodeFeedbackClipper::IterationStats stats;
+    for (const auto& stage : mStage1) stats.merge(stage.getIterationStats());
+    for (const auto& stage : mStage2) stats.merge(stage.getIterationStats());
+    return stats;
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::resetIterationStats() {
+    for (auto& stage : mStage1) stage.resetIterationStats();
+    for (auto& stage : mStage2) stage.resetIterationStats();
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::setLinkedLanes(bool linked) {
+    if (numLanes == 1) return;
+
+    // The lanes other than 0 have not run while linked: give them lane 0's
+    // state (the settings are the same in every lane)
+    if (mLinked && !linked) {
+        std::fill(mStage1.begin() + 1, mStage1.end(), mStage1[0]);
+        std::fill(mStage2.begin() + 1, mStage2.end(), mStage2[0]);
+        for (int lane = 1; lane < numLanes; ++lane) {   // they did no iterations
+            mStage1[static_cast<size_t>(lane)].resetIterationStats();
+            mStage2[static_cast<size_t>(lane)].resetIterationStats();
+        }
+        std::fill(mAdaa1.begin() + 1, mAdaa1.end(), mAdaa1[0]);
+        std::fill(mAdaa2.begin() + 1, mAdaa2.end(), mAdaa2[0]);
+    }
+    mCircuit.setLinkedLanes(linked);
+    mLinked = linked;
+}
+
+template <typename SampleType>
+double MT2GainStage<SampleType>::applyClip(double x, int mode) {
     switch (mode) {
-    case 1: return std::tanh(x);
-    case 2: return (2.0 / M_PI) * std::atan(x);
+    case 1: return fastmath::tanh(x);
+    case 2: return (2.0 / M_PI) * fastmath::atan(x);
     case 3: {
         double lo = -1.0, hi = 1.0;
         return x < lo ? lo : (x > hi ? hi : x);
     }
-    case 4: return x >= 0.0 ? std::tanh(x) : std::tanh(x * 0.5);
-    case 5: {
-        double y = std::sin(x);
-        return y;
-    }
-    default: return std::tanh(x);
+    case 4: return asymmetricTanh(x);
+    case 5: return fastmath::sin(x);
+    default: return fastmath::tanh(x);
     }
 }
 
-double MT2GainStage::processSample(double input) {
-    double after1;
+template <typename SampleType>
+SampleType MT2GainStage<SampleType>::processSample(SampleType input) {
+    SampleType output;
+    process(&input, &output, 1);
+    return output;
+}
+
+template <typename SampleType>
+void MT2GainStage<SampleType>::process(const SampleType* in, SampleType* out, int numSamples) {
+    pollDiodeTable();
+
+    if (mEngine == Engine::Circuit && mClipMode == 0) {
+        mCircuit.process(in, out, numSamples);
+        return;
+    }
+
+    // Clippers run lane by lane over the interleaved block; the static clip
+    // modes are per element, so they treat all lanes as one flat array.
+    const double* inFlat = simd::flat(in);
+    double* outFlat = simd::flat(out);
+    const int numValues = numSamples * numLanes;
+
+    // ADAA keeps one previous input per lane, so it also runs lane by lane.
+    // Linked lanes solve lane 0 and copy it to the others.
+    const bool adaa = mAntialiasing && mClipMode != 0;
+    const bool restart = mAdaaRestart;
+    mAdaaRestart = false;
+    const int activeLanes = mLinked ? 1 : numLanes;
+
     if (mClipMode == 0) {
-        after1 = mStage1.processSample(input);
+        for (int lane = 0; lane < activeLanes; ++lane)
+            mStage1[static_cast<size_t>(lane)].process(inFlat + lane, outFlat + lane, numSamples, numLanes);
+        if (mLinked) simd::copyFirstLane(out, numSamples);
+    } else if (adaa) {
+        for (int lane = 0; lane < activeLanes; ++lane)
+            clipBlockADAA(inFlat + lane, outFlat + lane, numSamples, numLanes, mStage1[0].getGain(), mClipMode,
+                          mAdaa1[static_cast<size_t>(lane)].x, mAdaa1[static_cast<size_t>(lane)].F, restart);
+        if (mLinked) simd::copyFirstLane(out, numSamples);
     } else {
-        double x = input * mStage1.getGain();
-        after1 = applyClip(x, mClipMode);
+        clipBlock(inFlat, outFlat, numValues, mStage1[0].getGain(), mClipMode);
     }
 
-    double hpfOut = mInterstageHPF.processSample(after1);
-    double lpfOut = mInterstageLPF.processSample(hpfOut);
+    mInterstageHPF.process(out, out, numSamples);
+    mInterstageLPF.process(out, out, numSamples);
 
-    double after2;
     if (mClipMode == 0) {
-        after2 = mStage2.processSample(lpfOut);
+        for (int lane = 0; lane < activeLanes; ++lane)
+            mStage2[static_cast<size_t>(lane)].process(outFlat + lane, outFlat + lane, numSamples, numLanes);
+        if (mLinked) simd::copyFirstLane(out, numSamples);
+    } else if (adaa) {
+        for (int lane = 0; lane < activeLanes; ++lane)
+            clipBlockADAA(outFlat + lane, outFlat + lane, numSamples, numLanes, 4.0, mClipMode,
+                          mAdaa2[static_cast<size_t>(lane)].x, mAdaa2[static_cast<size_t>(lane)].F, restart);
+        if (mLinked) simd::copyFirstLane(out, numSamples);
     } else {
-        double x = lpfOut * 4.0;
-        after2 = applyClip(x, mClipMode);
+        clipBlock(outFlat, outFlat, numValues, 4.0, mClipMode);
     }
-    return after2;
 }
+
+template class MT2GainStage<double>;
+template class MT2GainStage<simd::Double2>;
+template class MT2GainStage<simd::Double4>;
@@ -1,38 +1,165 @@
 #include "DSP/MT2ToneStack.h"
+#include <algorithm>
 #include <cmath>
 
-void MT2ToneStack::prepare(double sampleRate) {
+template <typename SampleType>
+void MT2ToneStack<SampleType>::Ramp::setTarget(double value, int rampSamples) {
+    if (value == target) return;
+    target = value;
+    remaining = std::max(1, rampSamples);
+    step = (target - current) / remaining;
+}
+
+template <typename SampleType>
+void MT2ToneStack<SampleType>::Ramp::advance(int numSamples) {
+    if (numSamples >= remaining) {
+        current = target;
+        remaining = 0;
+    } else {
+        current += step * numSamples;
+        remaining -= numSamples;
+    }
+}
+
+template <typename SampleType>
+void MT2ToneStack<SampleType>::prepare(double sampleRate) {
     mSampleRate = sampleRate;
+    mNeedsSnap = true;
     reset();
 }
 
-void MT2ToneStack::reset() {
+template <typename SampleType>
+void MT2ToneStack<SampleType>::reset() {
     mLowShelf.reset();
     mMidPeak.reset();
     mHighShelf.reset();
 }
 
-void MT2ToneStack::updateCoefficients(float eqLow, float eqMid, float eqMidFreq,
-                                      float eqMidQ, float eqHigh) {
+template <typename SampleType>
+typename BiquadFilter<SampleType>::Coefficients MT2ToneStack<SampleType>::makeLowShelf(double low) const {
     // Low Shelf: 200Hz, ±15dB, Q=0.707
-    double lowGain = (eqLow - 0.5f) * 30.0;  // -15dB to +15dB
-    mLowShelf.setLowShelf(200.0, lowGain, 0.707, mSampleRate);
+    double lowGain = (low - 0.5) * 30.0;  // -15dB to +15dB
+    return BiquadFilter<SampleType>::makeLowShelf(200.0, lowGain, 0.707, mSampleRate);
+}
 
+template <typename SampleType>
+typename BiquadFilter<SampleType>::Coefficients MT2ToneStack<SampleType>::makeMidPeak(double mid, double freq, double q) const {
     // Mid Peak: 200Hz~5000Hz (log sweep), ±20dB, Q=0.3~10.0 (log mapping)
-    double midGain = (eqMid - 0.5f) * 40.0;  // -20dB to +20dB
-    double midFreq = 200.0 * std::pow(5000.0 / 200.0, eqMidFreq);  // 200Hz to 5000Hz
-    double midQ = 0.3 * std::pow(10.0 / 0.3, eqMidQ);  // 0.3 to 10.0
-    mMidPeak.setPeak(midFreq, midGain, midQ, mSampleRate);
+    double midGain = (mid - 0.5) * 40.0;  // -20dB to +20dB
+    double midFreq = 200.0 * std::pow(5000.0 / 200.0, freq);  // 200Hz to 5000Hz
+    double midQ = 0.3 * std::pow(10.0 / 0.3, q);  // 0.3 to 10.0
+    return BiquadFilter<SampleType>::makePeak(midFreq, midGain, midQ, mSampleRate);
+}
 
+template <typename SampleType>
+typename BiquadFilter<SampleType>::Coefficients MT2ToneStack<SampleType>::makeHighShelf(double high) const {
     // High Shelf: 5000Hz, ±15dB, Q=0.707
-    double highGain = (eqHigh - 0.5f) * 30.0;  // -15dB to +15dB
-    mHighShelf.setHighShelf(5000.0, highGain, 0.707, mSampleRate);
+    double highGain = (high - 0.5) * 30.0;  // -15dB to +15dB
+    return BiquadFilter<SampleType>::makeHighShelf(5000.0, highGain, 0.707, mSampleRate);
+}
+
+template <typename SampleType>
+double MT2ToneStack<SampleType>::getMaxTailSamples(double decayDb) const {
+    // Ringing grows with boost, Q and low centre frequency; checking the
+    // ends and middle of every knob covers the worst case of each band
+    using Biquad = BiquadFilter<SampleType>;
+    constexpr double knobValues[] = { 0.0, 0.5, 1.0 };
+
+    double low = 0.0, mid = 0.0, high = 0.0;
+    for (double gain : knobValues) {
+        low = std::max(low, Biquad::getTailSamples(makeLowShelf(gain), decayDb));
+        high = std::max(high, Biquad::getTailSamples(makeHighShelf(gain), decayDb));
+        for (double freq : knobValues)
+            for (double q : knobValues)
+                mid = std::max(mid, Biquad::getTailSamples(makeMidPeak(gain, freq, q), decayDb));
+    }
+    return low + mid + high;
+}
+
+template <typename SampleType>
+void MT2ToneStack<SampleType>::updateCoefficients(float eqLow, float eqMid, float eqMidFreq,
+                                                  float eqMidQ, float eqHigh) {
+    const float input[NUM_KNOBS] = { eqLow, eqMid, eqMidFreq, eqMidQ, eqHigh };
+
+    if (mNeedsSnap) {
+        // First block after prepare: no ramp from stale values
+        for (int k = 0; k < NUM_KNOBS; ++k) {
+            mKnobs[k].snap(input[k]);
+            mLastInput[k] = input[k];
+        }
+        mLowShelf.setCoefficients(makeLowShelf(mKnobs[LOW].current));
+        mMidPeak.setCoefficients(makeMidPeak(mKnobs[MID].current, mKnobs[MID_FREQ].current, mKnobs[MID_Q].current));
+        mHighShelf.setCoefficients(makeHighShelf(mKnobs[HIGH].current));
+        mNeedsSnap = false;
+        return;
+    }
+
+    // Nothing to do unless a knob moved; the ramp itself runs in process()
+    const int rampSamples = static_cast<int>(RAMP_SECONDS * mSampleRate);
+    for (int k = 0; k < NUM_KNOBS; ++k) {
+        if (input[k] != mLastInput[k]) {
+            mLastInput[k] = input[k];
+            mKnobs[k].setTarget(input[k], rampSamples);
+        }
+    }
 }
 
-double MT2ToneStack::processSample(double input) {
+template <typename SampleType>
+SampleType MT2ToneStack<SampleType>::processSample(SampleType input) {
     // Process: Low Shelf → Mid Peak → High Shelf
-    double lsOut = mLowShelf.processSample(input);
-    double midOut = mMidPeak.processSample(lsOut);
-    double hsOut = mHighShelf.processSample(midOut);
-    return hsOut;
+    SampleType output;
+    process(&input, &output, 1);
+    return output;
 }
+
+template <typename SampleType>
+void MT2ToneStack<SampleType>::process(const SampleType* in, SampleType* out, int numSamples) {
+    bool lowMoving = mKnobs[LOW].isRamping();
+    bool midMoving = mKnobs[MID].isRamping() || mKnobs[MID_FREQ].isRamping() || mKnobs[MID_Q].isRamping();
+    bool highMoving = mKnobs[HIGH].isRamping();
+
+    if (!lowMoving && !midMoving && !highMoving) {
+        // Steady state: fixed coefficients, each biquad over the whole block
+        mLowShelf.process(in, out, numSamples);
+        mMidPeak.process(out, out, numSamples);
+        mHighShelf.process(out, out, numSamples);
+        return;
+    }
+
+    // Ramping: redesign at sub-block ends, interpolate per sample in between.
+    // A band whose ramp ends inside a sub-block still lands on its final
+    // coefficients there and runs fixed from the next sub-block on.
+    for (int start = 0; start < numSamples; start += SUB_BLOCK) {
+        const int n = std::min(SUB_BLOCK, numSamples - start);
+        const SampleType* src = in + start;
+        SampleType* dst = out + start;
+
+        for (auto& knob : mKnobs)
+            knob.advance(n);
+
+        if (lowMoving) {
+            mLowShelf.processRamp(src, dst, n, makeLowShelf(mKnobs[LOW].current));
+            lowMoving = mKnobs[LOW].isRamping();
+        } else {
+            mLowShelf.process(src, dst, n);
+        }
+
+        if (midMoving) {
+            mMidPeak.processRamp(dst, dst, n, makeMidPeak(mKnobs[MID].current, mKnobs[MID_FREQ].current, mKnobs[MID_Q].current));
+            midMoving = mKnobs[MID].isRamping() || mKnobs[MID_FREQ].isRamping() || mKnobs[MID_Q].isRamping();
+        } else {
+            mMidPeak.process(dst, dst, n);
+        }
+
+        if (highMoving) {
+            mHighShelf.processRamp(dst, dst, n, makeHighShelf(mKnobs[HIGH].current));
+            highMoving = mKnobs[HIGH].isRamping();
+        } else {
+            mHighShelf.process(dst, dst, n);
+        }
+    }
+}
+
+template class MT2ToneStack<double>;
+template class MT2ToneStack<simd::Double2>;
+template class MT2ToneStack<simd::Double4>;
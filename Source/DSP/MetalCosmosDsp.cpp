@@ -0,0 +1,99 @@
+#include "DSP/MetalCosmosDsp.h"
+#include "DSP/MT2BatchEngine.h"
+#include <exception>
+#include <memory>
+
+// The C interface owns an engine; no exception crosses it
+struct MT2Batch {
+    explicit MT2Batch(const MT2BatchConfig& config) : engine(config) {}
+    MT2BatchEngine engine;
+};
+
+namespace {
+    template <typename FloatType>
+    int processBatch(MT2Batch* batch, const FloatType* const* inputs, FloatType* const* outputs, int numSamples) {
+        if (batch == nullptr || numSamples < 0 || (batch->engine.getNumStreams() > 0 && (inputs == nullptr || outputs == nullptr)))
+            return MT2_ERROR_ARGUMENT;
+        if (!batch->engine.isStarted())
+            return MT2_ERROR_NOT_STARTED;
+        batch->engine.process(inputs, outputs, numSamples);
+        return MT2_OK;
+    }
+}
+
+extern "C" {
+
+void mt2_stream_params_init(MT2StreamParams* params) {
+    if (params == nullptr) return;
+    // The plugin's parameter defaults (Parameters.h)
+    params->dist = 0.5f;
+    params->diodeMorph = 0.0f;
+    params->diodeLink = 1;
+    params->diodeMorph2 = 0.0f;
+    params->clipMode = 0;
+    params->clipAntialiasing = 1;
+    params->circuitModel = 0;
+    params->diodeSolver = 1;
+    params->solverQuality = 1;
+    params->eqLow = 0.5f;
+    params->eqMid = 0.5f;
+    params->eqMidFreq = 0.5f;
+    params->eqMidQ = 0.3f;
+    params->eqHigh = 0.5f;
+    params->satAmount = 0.3f;
+    params->satPosition = 1;
+}
+
+void mt2_batch_config_init(MT2BatchConfig* config) {
+    if (config == nullptr) return;
+    config->numStreams = 1;
+    config->sampleRate = 48000.0;
+    config->maxBlockSize = 512;
+    config->oversamplingFactorLog2 = 1;
+    config->minimumPhase = 0;
+    config->renderProfile = 0;
+}
+
+MT2Batch* mt2_batch_create(const MT2BatchConfig* config) {
+    if (config == nullptr) return nullptr;
+    try {
+        return new MT2Batch(*config);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void mt2_batch_destroy(MT2Batch* batch) {
+    delete batch;
+}
+
+int mt2_batch_set_stream_params(MT2Batch* batch, int stream, const MT2StreamParams* params) {
+    if (batch == nullptr || params == nullptr || stream < 0 || stream >= batch->engine.getNumStreams())
+        return MT2_ERROR_ARGUMENT;
+    batch->engine.setStreamParams(stream, *params);
+    return MT2_OK;
+}
+
+int mt2_batch_start(MT2Batch* batch) {
+    if (batch == nullptr) return MT2_ERROR_ARGUMENT;
+    try {
+        batch->engine.start();
+        return MT2_OK;
+    } catch (const std::exception&) {
+        return MT2_ERROR_INTERNAL;
+    }
+}
+
+int mt2_batch_process(MT2Batch* batch, const float* const* inputs, float* const* outputs, int numSamples) {
+    return processBatch(batch, inputs, outputs, numSamples);
+}
+
+int mt2_batch_process_double(MT2Batch* batch, const double* const* inputs, double* const* outputs, int numSamples) {
+    return processBatch(batch, inputs, outputs, numSamples);
+}
+
+int mt2_batch_get_latency(const MT2Batch* batch) {
+    return batch != nullptr ? batch->engine.getLatencySamples() : MT2_ERROR_ARGUMENT;
+}
+
+} // extern "C"
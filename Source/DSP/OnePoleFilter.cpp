@@ -1,13 +1,17 @@
 #include "DSP/OnePoleFilter.h"
+#include "DSP/DecayTime.h"
 #include <cmath>
 
-OnePoleFilter::OnePoleFilter(Type type) : mType(type) {}
+template <typename SampleType>
+OnePoleFilter<SampleType>::OnePoleFilter(Type type) : mType(type) {}
 
-void OnePoleFilter::setType(Type type) {
+template <typename SampleType>
+void OnePoleFilter<SampleType>::setType(Type type) {
     mType = type;
 }
 
-void OnePoleFilter::setCutoffFrequency(double freqHz, double sampleRate) {
+template <typename SampleType>
+void OnePoleFilter<SampleType>::setCutoffFrequency(double freqHz, double sampleRate) {
     // TPT (Topology Preserving Transform) coefficients
     // g = tan(pi * fc / fs)
     double g = std::tan(M_PI * freqHz / sampleRate);
@@ -18,31 +22,64 @@ void OnePoleFilter::setCutoffFrequency(double freqHz, double sampleRate) {
         mA0 = G;
         mB1 = 1.0 - G;
     } else {
-        // HPF using TPT structure
-        // HPF: y[n] = (x[n] - x[n-1]) * G + y[n-1] (simplified TPT HPF)
-        // More precise TPT HPF:
-        // y[n] = (1 - G) * x[n] - (1 - G) * x[n-1] + (1 - 2*G) * y[n-1]
-        // Standard first-order HPF via bilinear transform:
-        mA0 = 1.0 - G;
-        mB1 = -G;
+        // HPF: TPT one-pole, x minus its lowpass part
+        //   v = G·(x - s), lp = v + s, s' = lp + v, y = x - lp
+        // a0 = G; b1 = 1 - 2G is the state pole (for the tail)
+        mA0 = G;
+        mB1 = 1.0 - 2.0 * G;
     }
 }
 
-void OnePoleFilter::reset() {
-    mZ1 = 0.0;
+template <typename SampleType>
+void OnePoleFilter<SampleType>::reset() {
+    mZ1 = SampleType {};
+}
+
+template <typename SampleType>
+double OnePoleFilter<SampleType>::getTailSamples(double decayDb) const {
+    // b1 is the pole of either form
+    return decaySamples(mB1, decayDb);
 }
 
-double OnePoleFilter::processSample(double input) {
+template <typename SampleType>
+SampleType OnePoleFilter<SampleType>::processSample(SampleType input) {
     if (mType == Type::LPF) {
         // LPF: y[n] = a0 * x[n] + b1 * y[n-1]
-        double output = mA0 * input + mB1 * mZ1;
+        SampleType output = mA0 * input + mB1 * mZ1;
         mZ1 = output;
         return output;
     } else {
-        // HPF: y[n] = a0 * (x[n] - x[n-1]) + (1 - a0) * y[n-1]
-        // This is the TPT structure for HPF
-        double output = mA0 * (input - mZ1) + mB1 * mZ1;
-        mZ1 = input;
-        return output;
+        SampleType v = mA0 * (input - mZ1);
+        SampleType lowpass = v + mZ1;
+        mZ1 = lowpass + v;
+        return input - lowpass;
     }
 }
+
+template <typename SampleType>
+void OnePoleFilter<SampleType>::process(const SampleType* in, SampleType* out, int numSamples) {
+    // Type branch hoisted out of the loop; state kept in a local
+    const double a0 = mA0, b1 = mB1;   // b1 only used by the LPF
+    SampleType z1 = mZ1;
+
+    if (mType == Type::LPF) {
+        for (int i = 0; i < numSamples; ++i) {
+            SampleType output = a0 * in[i] + b1 * z1;
+            z1 = output;
+            out[i] = output;
+        }
+    } else {
+        for (int i = 0; i < numSamples; ++i) {
+            SampleType input = in[i];
+            SampleType v = a0 * (input - z1);
+            SampleType lowpass = v + z1;
+            z1 = lowpass + v;
+            out[i] = input - lowpass;
+        }
+    }
+    mZ1 = z1;
+}
+
+template class OnePoleFilter<double>;
+template class OnePoleFilter<simd::Double2>;
+template class OnePoleFilter<simd::Double4>;
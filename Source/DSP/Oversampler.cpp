@@ -0,0 +1,415 @@
+#include "DSP/Oversampler.h"
+#include "DSP/DecayTime.h"
+#include "DSP/SharedTables.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Zeroth-order modified Bessel function (Kaiser window)
+    double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-17) break;
+        }
+        return sum;
+    }
+
+    // Kaiser-windowed sinc half-band: the K unique non-centre taps
+    std::vector<double> designHalfBandKernel(int K, double attenuationDb) {
+        const double centre = 2.0 * K - 1.0;
+        const double beta = attenuationDb > 50.0 ? 0.1102 * (attenuationDb - 8.7)
+                                                 : 0.5842 * std::pow(attenuationDb - 21.0, 0.4)
+                                                   + 0.07886 * (attenuationDb - 21.0);
+
+        // Non-zero taps sit at even indices j = 2k (the centre tap is odd)
+        std::vector<double> coefs(static_cast<size_t>(K), 0.0);
+        double sum = 0.0;
+        for (int k = 0; k < K; ++k) {
+            const double t = (2.0 * k - centre) * 0.5;
+            const double r = (2.0 * k - centre) / centre;
+            const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+            coefs[static_cast<size_t>(k)] = 0.5 * std::sin(M_PI * t) / (M_PI * t) * window;
+            sum += 2.0 * coefs[static_cast<size_t>(k)];
+        }
+
+        // Unity DC gain: each polyphase branch sums to 0.5
+        for (auto& c : coefs)
+            c *= 0.5 / sum;
+        return coefs;
+    }
+
+    // Elliptic half-band allpass coefficients (Valenzuela & Constantinides,
+    // in the form used by Laurent de Soras' HIIR)
+    double ellipticNum(double q, int order, int c) {
+        double acc = 0.0, term;
+        int i = 0, sign = 1;
+        do {
+            term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * M_PI / order) * sign;
+            acc += term;
+            sign = -sign;
+            ++i;
+        } while (std::abs(term) > 1e-100);
+        return acc;
+    }
+
+    double ellipticDen(double q, int order, int c) {
+        double acc = 0.0, term;
+        int i = 1, sign = -1;
+        do {
+            term = std::pow(q, i * i) * std::cos(i * 2 * c * M_PI / order) * sign;
+            acc += term;
+            sign = -sign;
+            ++i;
+        } while (std::abs(term) > 1e-100);
+        return acc;
+    }
+
+    void designHalfBandAllpass(double* coefs, int numCoefs, double transition) {
+        double k = std::tan((1.0 - transition * 2.0) * M_PI / 4.0);
+        k *= k;
+        const double kksqrt = std::pow(1.0 - k * k, 0.25);
+        const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+        const double e2 = e * e;
+        const double e4 = e2 * e2;
+        const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const int order = numCoefs * 2 + 1;
+        for (int i = 0; i < numCoefs; ++i) {
+            const int c = i + 1;
+            const double num = ellipticNum(q, order, c) * std::pow(q, 0.25);
+            const double den = ellipticDen(q, order, c) + 0.5;
+            const double ww = num / den;
+            const double wwsq = ww * ww;
+            const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+            coefs[i] = (1.0 - x) / (1.0 + x);
+        }
+    }
+
+    // Per-stage designs: the first 2x stage carries the audio band edge, later
+    // stages only have to reject images far above it and can be much shorter.
+    struct FirSpec { int numCoefs; double attenuationDb; };
+    struct IirSpec { int numCoefs; double transition; };
+    constexpr FirSpec kFirSpecs[] = { { 32, 90.0 }, { 8, 90.0 }, { 5, 90.0 } };
+    constexpr IirSpec kIirSpecs[] = { { 8, 0.04 }, { 4, 0.18 }, { 3, 0.30 } };
+
+    // Render quality: ~120 dB stopbands and a narrower first transition band
+    constexpr FirSpec kRenderFirSpecs[] = { { 64, 120.0 }, { 12, 120.0 }, { 8, 120.0 } };
+    constexpr IirSpec kRenderIirSpecs[] = { { 12, 0.03 }, { 6, 0.15 }, { 4, 0.25 } };
+}
+
+// ============================================================================
+// HalfBandFIR
+// ============================================================================
+
+template <typename SampleType>
+void HalfBandFIR<SampleType>::design(int numCoefs, double attenuationDb) {
+    // The kernel only depends on the design: one copy per process
+    const int K = std::max(1, numCoefs);
+    mCoefs = SharedTables::get<std::vector<double>>({ "halfband-fir", 0.0, K, attenuationDb }, [K, attenuationDb] {
+        return std::make_shared<const std::vector<double>>(designHalfBandKernel(K, attenuationDb));
+    });
+}
+
+template <typename SampleType>
+void HalfBandFIR<SampleType>::prepare(int maxInputSamples) {
+    const size_t K = mCoefs->size();
+    mUpWork.assign(2 * K - 1 + static_cast<size_t>(maxInputSamples), SampleType {});
+    mDownWork.assign(4 * K - 2 + 2 * static_cast<size_t>(maxInputSamples), SampleType {});
+}
+
+template <typename SampleType>
+void HalfBandFIR<SampleType>::reset() {
+    std::fill(mUpWork.begin(), mUpWork.end(), SampleType {});
+    std::fill(mDownWork.begin(), mDownWork.end(), SampleType {});
+}
+
+template <typename SampleType>
+void HalfBandFIR<SampleType>::upsample(const SampleType* in, SampleType* out, int numSamples) {
+    const int K = static_cast<int>(mCoefs->size());
+    const int history = 2 * K - 1;
+    SampleType* work = mUpWork.data();
+    const double* g = mCoefs->data();
+
+    std::copy(in, in + numSamples, work + history);
+
+    for (int i = 0; i < numSamples; ++i) {
+        const SampleType* x = work + history + i;   // x[0] = newest input
+        // Two accumulators halve the dependency chain of the sum
+        SampleType acc0 {}, acc1 {};
+        int k = 0;
+        for (; k + 1 < K; k += 2) {
+            acc0 = acc0 + g[k] * (x[-k] + x[-(2 * K - 1 - k)]);
+            acc1 = acc1 + g[k + 1] * (x[-(k + 1)] + x[-(2 * K - 2 - k)]);
+        }
+        if (k < K)
+            acc0 = acc0 + g[k] * (x[-k] + x[-(2 * K - 1 - k)]);
+
+        out[2 * i] = 2.0 * (acc0 + acc1);   // zero-stuffing gain of 2
+        out[2 * i + 1] = x[-(K - 1)];       // centre tap: 2 · 0.5
+    }
+
+    std::copy(work + numSamples, work + numSamples + history, work);
+}
+
+template <typename SampleType>
+void HalfBandFIR<SampleType>::downsample(const SampleType* in, SampleType* out, int numSamples) {
+    const int K = static_cast<int>(mCoefs->size());
+    const int history = 4 * K - 2;
+    SampleType* work = mDownWork.data();
+    const double* g = mCoefs->data();
+
+    std::copy(in, in + 2 * numSamples, work + history);
+
+    for (int i = 0; i < numSamples; ++i) {
+        const SampleType* v = work + history + 2 * i;
+        SampleType acc0 = 0.5 * v[-(2 * K - 1)], acc1 {};
+        int k = 0;
+        for (; k + 1 < K; k += 2) {
+            acc0 = acc0 + g[k] * (v[-2 * k] + v[-(4 * K - 2 - 2 * k)]);
+            acc1 = acc1 + g[k + 1] * (v[-2 * (k + 1)] + v[-(4 * K - 4 - 2 * k)]);
+        }
+        if (k < K)
+            acc0 = acc0 + g[k] * (v[-2 * k] + v[-(4 * K - 2 - 2 * k)]);
+        out[i] = acc0 + acc1;
+    }
+
+    std::copy(work + 2 * numSamples, work + 2 * numSamples + history, work);
+}
+
+// ============================================================================
+// HalfBandIIR
+// ============================================================================
+
+template <typename SampleType>
+void HalfBandIIR<SampleType>::design(int numCoefs, double transition) {
+    mNumCoefs = std::clamp(numCoefs, 1, MAX_COEFS);
+    designHalfBandAllpass(mCoefs.data(), mNumCoefs, transition);
+    reset();
+}
+
+template <typename SampleType>
+void HalfBandIIR<SampleType>::reset() {
+    mUp = Chain {};
+    mDown = Chain {};
+}
+
+template <typename SampleType>
+void HalfBandIIR<SampleType>::Chain::process(const double* coefs, int numCoefs,
+                                              SampleType& even, SampleType& odd) {
+    for (int i = 0; i < numCoefs; i += 2) {
+        const SampleType t0 = (even - y[i]) * coefs[i] + x[i];
+        x[i] = even;
+        y[i] = t0;
+        even = t0;
+
+        if (i + 1 < numCoefs) {
+            const SampleType t1 = (odd - y[i + 1]) * coefs[i + 1] + x[i + 1];
+            x[i + 1] = odd;
+            y[i + 1] = t1;
+            odd = t1;
+        }
+    }
+}
+
+template <typename SampleType>
+void HalfBandIIR<SampleType>::upsample(const SampleType* in, SampleType* out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        SampleType even = in[i];
+        SampleType odd = in[i];
+        mUp.process(mCoefs.data(), mNumCoefs, even, odd);
+        out[2 * i] = even;
+        out[2 * i + 1] = odd;
+    }
+}
+
+template <typename SampleType>
+void HalfBandIIR<SampleType>::downsample(const SampleType* in, SampleType* out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        SampleType even = in[2 * i + 1];
+        SampleType odd = in[2 * i];
+        mDown.process(mCoefs.data(), mNumCoefs, even, odd);
+        out[i] = 0.5 * (even + odd);
+    }
+}
+
+template <typename SampleType>
+double HalfBandIIR<SampleType>::getLatency() const {
+    // Each section (a + z^-2) / (1 + a·z^-2) delays DC by 2(1-a)/(1+a) samples.
+    // DC sees the mean of the two paths; the odd path's one-sample offset
+    // adds half a sample on the way up and takes it back on the way down.
+    double delay = 0.0;
+    for (int i = 0; i < mNumCoefs; ++i)
+        delay += (1.0 - mCoefs[static_cast<size_t>(i)]) / (1.0 + mCoefs[static_cast<size_t>(i)]);
+
+    return 2.0 * delay;   // (mean of both paths) × (up + down)
+}
+
+template <typename SampleType>
+double HalfBandIIR<SampleType>::getTailSamples(double decayDb) const {
+    // A section in z^-2 has its poles at radius sqrt(|a|)
+    double tail = 0.0;
+    for (int i = 0; i < mNumCoefs; ++i)
+        tail += decaySamples(std::sqrt(std::abs(mCoefs[static_cast<size_t>(i)])), decayDb);
+
+    return 2.0 * tail;   // up + down
+}
+
+// ============================================================================
+// Oversampler
+// ============================================================================
+
+template <typename SampleType>
+Oversampler<SampleType>::Oversampler() {
+    for (int s = 0; s < MAX_STAGES; ++s) {
+        mFir[static_cast<size_t>(s)].design(kFirSpecs[s].numCoefs, kFirSpecs[s].attenuationDb);
+        mIir[static_cast<size_t>(s)].design(kIirSpecs[s].numCoefs, kIirSpecs[s].transition);
+    }
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::setQuality(Quality quality) {
+    if (quality == mQuality)
+        return;
+    mQuality = quality;
+
+    const FirSpec* firSpecs = (quality == Quality::Render) ? kRenderFirSpecs : kFirSpecs;
+    const IirSpec* iirSpecs = (quality == Quality::Render) ? kRenderIirSpecs : kIirSpecs;
+    for (int s = 0; s < MAX_STAGES; ++s) {
+        mFir[static_cast<size_t>(s)].design(firSpecs[s].numCoefs, firSpecs[s].attenuationDb);
+        mIir[static_cast<size_t>(s)].design(iirSpecs[s].numCoefs, iirSpecs[s].transition);
+    }
+
+    // The FIR history length follows the kernel
+    if (mMaxBlockSize > 0)
+        prepare(mMaxBlockSize);
+    updatePadding();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::prepare(int maxBlockSize) {
+    mMaxBlockSize = maxBlockSize;
+    for (int k = 0; k <= MAX_STAGES; ++k)
+        mBuffers[static_cast<size_t>(k)].assign(static_cast<size_t>(maxBlockSize) << k, SampleType {});
+
+    for (int s = 0; s < MAX_STAGES; ++s)
+        mFir[static_cast<size_t>(s)].prepare(maxBlockSize << s);
+
+    reset();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::reset() {
+    for (auto& stage : mFir) stage.reset();
+    for (auto& stage : mIir) stage.reset();
+    mPad.fill(SampleType {});
+    mPadPos = 0;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::setConfig(int factorLog2, Phase phase) {
+    factorLog2 = std::clamp(factorLog2, 0, MAX_STAGES);
+    if (factorLog2 == mNumStages && phase == mPhase)
+        return;
+
+    mNumStages = factorLog2;
+    mPhase = phase;
+    reset();
+    updatePadding();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::updatePadding() {
+    // Linear-phase delay of the cascade, counted in samples at the top rate
+    const int topFactor = getFactor();
+    int delay = 0;
+    for (int s = 0; s < mNumStages; ++s)
+        delay += mFir[static_cast<size_t>(s)].getLatency() * (topFactor >> (s + 1));
+
+    mPadLength = (mPhase == Phase::Linear) ? (topFactor - delay % topFactor) % topFactor : 0;
+    mPadPos = 0;
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getLatencySamples() const {
+    if (mPhase == Phase::Minimum) {
+        double delay = 0.0;
+        for (int s = 0; s < mNumStages; ++s)
+            delay += mIir[static_cast<size_t>(s)].getLatency() / static_cast<double>(2 << s);
+        return static_cast<int>(std::lround(delay));
+    }
+
+    const int topFactor = getFactor();
+    int delay = mPadLength;
+    for (int s = 0; s < mNumStages; ++s)
+        delay += mFir[static_cast<size_t>(s)].getLatency() * (topFactor >> (s + 1));
+    return delay / topFactor;
+}
+
+template <typename SampleType>
+double Oversampler<SampleType>::getTailSamples(double decayDb) const {
+    double tail = (mPhase == Phase::Linear) ? static_cast<double>(mPadLength) / getFactor() : 0.0;
+    for (int s = 0; s < mNumStages; ++s) {
+        const double stageTail = (mPhase == Phase::Linear) ? mFir[static_cast<size_t>(s)].getTailSamples()
+                                                            : mIir[static_cast<size_t>(s)].getTailSamples(decayDb);
+        tail += stageTail / static_cast<double>(2 << s);
+    }
+    return std::ceil(tail);
+}
+
+template <typename SampleType>
+SampleType* Oversampler<SampleType>::processUp(const SampleType* in, int numSamples) {
+    if (mNumStages == 0) {
+        std::copy(in, in + numSamples, mBuffers[0].data());
+        return mBuffers[0].data();
+    }
+
+    const SampleType* src = in;
+    for (int s = 0; s < mNumStages; ++s) {
+        SampleType* dst = mBuffers[static_cast<size_t>(s + 1)].data();
+        if (mPhase == Phase::Linear)
+            mFir[static_cast<size_t>(s)].upsample(src, dst, numSamples << s);
+        else
+            mIir[static_cast<size_t>(s)].upsample(src, dst, numSamples << s);
+        src = dst;
+    }
+    return mBuffers[static_cast<size_t>(mNumStages)].data();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::processDown(SampleType* out, int numSamples) {
+    if (mNumStages == 0) {
+        std::copy(mBuffers[0].data(), mBuffers[0].data() + numSamples, out);
+        return;
+    }
+
+    if (mPadLength > 0) {
+        SampleType* top = mBuffers[static_cast<size_t>(mNumStages)].data();
+        for (int i = 0; i < (numSamples << mNumStages); ++i) {
+            const SampleType delayed = mPad[static_cast<size_t>(mPadPos)];
+            mPad[static_cast<size_t>(mPadPos)] = top[i];
+            top[i] = delayed;
+            if (++mPadPos == mPadLength) mPadPos = 0;
+        }
+    }
+
+    for (int s = mNumStages - 1; s >= 0; --s) {
+        const SampleType* src = mBuffers[static_cast<size_t>(s + 1)].data();
+        SampleType* dst = (s == 0) ? out : mBuffers[static_cast<size_t>(s)].data();
+        if (mPhase == Phase::Linear)
+            mFir[static_cast<size_t>(s)].downsample(src, dst, numSamples << s);
+        else
+            mIir[static_cast<size_t>(s)].downsample(src, dst, numSamples << s);
+    }
+}
+
+template class HalfBandFIR<double>;
+template class HalfBandFIR<simd::Double2>;
+template class HalfBandFIR<simd::Double4>;
+template class HalfBandIIR<double>;
+template class HalfBandIIR<simd::Double2>;
+template class HalfBandIIR<simd::Double4>;
+template class Oversampler<double>;
+template class Oversampler<simd::Double2>;
+template class Oversampler<simd::Double4>;
@@ -0,0 +1,55 @@
+#include "DSP/SharedTables.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+namespace {
+    using EntryKey = std::pair<std::type_index, SharedTables::Key>;
+
+    struct Registry {
+        std::mutex mutex;
+        std::map<EntryKey, std::weak_ptr<const void>> entries;
+
+        // Drop entries whose last user has gone (they only hold the key now)
+        void prune() {
+            for (auto it = entries.begin(); it != entries.end();)
+                it = it->second.expired() ? entries.erase(it) : std::next(it);
+        }
+    };
+
+    // Function-local static: safe to use from other statics' constructors
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+}
+
+bool SharedTables::Key::operator<(const Key& other) const {
+    return std::tie(kind, sampleRate, quality, detail)
+         < std::tie(other.kind, other.sampleRate, other.quality, other.detail);
+}
+
+std::shared_ptr<const void> SharedTables::getErased(std::type_index type, const Key& key,
+                                                    const std::function<std::shared_ptr<const void>()>& build) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto& entry = reg.entries[EntryKey(type, key)];
+    if (auto table = entry.lock())
+        return table;
+
+    // Built under the lock: instances prepared in parallel wait for the
+    // first build instead of each building their own copy
+    auto table = build();
+    entry = table;
+    reg.prune();
+    return table;
+}
+
+int SharedTables::getNumEntries() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.prune();
+    return static_cast<int>(reg.entries.size());
+}
@@ -0,0 +1,39 @@
+#include "LoadMeter.h"
+
+MT2LoadMeter::MT2LoadMeter()
+    : mSecondsPerTick(1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()))
+{
+}
+
+void MT2LoadMeter::publish(const Block& block, juce::int64 end)
+{
+    // The reader saw the previous peaks: start a new window
+    if (mPeaksRead.load(std::memory_order_relaxed) && mPeaksRead.exchange(false, std::memory_order_relaxed)) {
+        mTotals.peakLoad = 0.0;
+        mTotals.maxIterations = 0;
+    }
+
+    for (size_t s = 0; s < NumStages; ++s)
+        mTotals.stageSeconds[s] += static_cast<double>(block.mStageTicks[s]) * mSecondsPerTick;
+
+    const double busy = static_cast<double>(end - block.mStart) * mSecondsPerTick;
+    mTotals.busySeconds += busy;
+    mTotals.audioSeconds += block.mDeadline;
+    mTotals.blocks += 1;
+    mTotals.solves += static_cast<juce::uint64>(block.mSolves);
+    mTotals.iterations += static_cast<juce::uint64>(block.mIterations);
+    if (block.mDeadline > 0.0)
+        mTotals.peakLoad = std::max(mTotals.peakLoad, busy / block.mDeadline);
+    mTotals.maxIterations = std::max(mTotals.maxIterations, block.mMaxIterations);
+
+    mReports.write(mTotals);
+}
+
+bool MT2LoadMeter::read(Report& out)
+{
+    if (!mReports.read(out))
+        return false;
+
+    mPeaksRead.store(true, std::memory_order_relaxed);
+    return true;
+}
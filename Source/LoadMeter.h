@@ -0,0 +1,114 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "TripleBuffer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+/** DSP load of processBlock, per stage, for the editor.
+
+    - The audio thread times each stage with the high-resolution tick
+      counter and keeps running totals. Readers diff two reports, so the
+      figures cover exactly the time between their polls.
+    - Reports go through a TripleBuffer: the audio thread publishes with
+      one atomic exchange, the reader takes the newest with another. Neither
+      side ever waits or retries.
+    - Nothing is timed or published while no one is watching: every hook
+      is one predictable branch on a flag read once per block.
+
+    One audio thread writes; one reader (the editor's timer) reads.
+*/
+class MT2LoadMeter {
+public:
+    /** Pre and post saturation are fused with the lane packing, so their
+        times include the conversion from and to the host buffer. */
+    enum Stage { PreSat, GainStage, ToneStack, PostSat, NumStages };
+
+    /** Running totals since the meter was created */
+    struct Report {
+        std::array<double, NumStages> stageSeconds {};
+        double busySeconds = 0.0;      // the whole of processBlock
+        double audioSeconds = 0.0;     // audio processed (the deadline)
+        juce::uint64 blocks = 0;
+        juce::uint64 solves = 0;       // diode samples solved iteratively
+        juce::uint64 iterations = 0;
+
+        // Worst case since the previous read(), not running totals
+        double peakLoad = 0.0;         // busy / deadline of a single block
+        int maxIterations = 0;
+    };
+
+    /** Times one processBlock call. Stage times run from the previous lap
+        (or the start of the block); the block is published when this goes
+        out of scope, including early returns. */
+    class Block {
+    public:
+        Block(MT2LoadMeter& meter, int numSamples, double sampleRate)
+            : mMeter(meter), mActive(meter.isActive())
+        {
+            if (mActive) {
+                mDeadline = numSamples / sampleRate;
+                mStart = mLast = juce::Time::getHighResolutionTicks();
+            }
+        }
+
+        ~Block()
+        {
+            if (mActive)
+                mMeter.publish(*this, juce::Time::getHighResolutionTicks());
+        }
+
+        bool isActive() const { return mActive; }
+
+        void lap(Stage stage)
+        {
+            if (!mActive) return;
+            const auto now = juce::Time::getHighResolutionTicks();
+            mStageTicks[static_cast<size_t>(stage)] += now - mLast;
+            mLast = now;
+        }
+
+        void addIterations(int solves, int iterations, int maxIterations)
+        {
+            mSolves += solves;
+            mIterations += iterations;
+            mMaxIterations = std::max(mMaxIterations, maxIterations);
+        }
+
+    private:
+        friend class MT2LoadMeter;
+
+        MT2LoadMeter& mMeter;
+        const bool mActive;
+        double mDeadline = 0.0;
+        juce::int64 mStart = 0, mLast = 0;
+        std::array<juce::int64, NumStages> mStageTicks {};
+        int mSolves = 0, mIterations = 0, mMaxIterations = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(Block)
+    };
+
+    MT2LoadMeter();
+
+    /** Reader side. The meter only runs while at least one reader is attached. */
+    void attach() { mReaders.fetch_add(1, std::memory_order_relaxed); }
+    void detach() { mReaders.fetch_sub(1, std::memory_order_relaxed); }
+    bool isActive() const { return mReaders.load(std::memory_order_relaxed) > 0; }
+
+    /** Copies the newest report into out. Returns false (out untouched) if
+        nothing was published since the last call. */
+    bool read(Report& out);
+
+private:
+    void publish(const Block& block, juce::int64 end);
+
+    TripleBuffer<Report> mReports;
+    std::atomic<bool> mPeaksRead { false };
+    std::atomic<int> mReaders { 0 };
+
+    // Audio thread only
+    Report mTotals;
+    double mSecondsPerTick = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MT2LoadMeter)
+};
@@ -0,0 +1,139 @@
+#include "ParameterSnapshot.h"
+#include "DSP/MT2GainStage.h"
+#include "DSP/SharedTables.h"
+#include <cmath>
+
+namespace {
+    constexpr const char* kParameterIds[MT2ParameterSnapshot::NumParams] = {
+        "dist", "level", "diode_morph", "diode_link", "diode_morph_2",
+        "eq_low", "eq_mid", "eq_mid_freq", "eq_mid_q", "eq_high",
+        "clip_mode", "out_sat", "sat_pos", "diode_solver", "solver_quality", "clip_adaa", "circuit_model", "os_factor", "os_phase",
+    };
+
+    double distToGain(float dist) { return MT2GainStage<double>::gainForDist(dist); }
+
+    // Number of steps of a stepped range (1 if it is continuous)
+    int numSteps(const juce::NormalisableRange<float>& range) {
+        if (range.interval <= 0.0f) return 1;
+        return juce::roundToInt((range.end - range.start) / range.interval) + 1;
+    }
+}
+
+MT2ParameterSnapshot::MT2ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts)
+{
+    mIndexToParam.assign(static_cast<size_t>(apvts.processor.getParameters().size()), -1);
+
+    for (int p = 0; p < NumParams; ++p) {
+        auto* param = apvts.getParameter(kParameterIds[p]);
+        jassert(param != nullptr);   // every ID must exist in MT2Params::createLayout
+        mParams[static_cast<size_t>(p)] = param;
+
+        if (param != nullptr) {
+            mIndexToParam[static_cast<size_t>(param->getParameterIndex())] = p;
+            param->addListener(this);
+        }
+    }
+
+    // Derived tables: one entry per parameter step (dist and both diode
+    // morphs are stepped, so every value the host can set is in the table).
+    // Every instance has the same ranges, so the tables are shared process-wide.
+    if (auto* dist = mParams[Dist]) {
+        const auto range = dist->getNormalisableRange();
+        mGainTable = SharedTables::get<std::vector<double>>({ "param-dist-gain", 0.0, numSteps(range), range.interval }, [range] {
+            auto table = std::make_shared<std::vector<double>>();
+            for (int i = 0; i < numSteps(range); ++i)
+                table->push_back(distToGain(range.start + static_cast<float>(i) * range.interval));
+            return std::shared_ptr<const std::vector<double>>(std::move(table));
+        });
+    }
+    if (auto* morph = mParams[DiodeMorph]) {
+        const auto range = morph->getNormalisableRange();
+        mDiodeTable = SharedTables::get<std::vector<DiodeParams>>({ "param-diode-morph", 0.0, numSteps(range), range.interval }, [range] {
+            const DiodeMorpher morpher;
+            auto table = std::make_shared<std::vector<DiodeParams>>();
+            for (int i = 0; i < numSteps(range); ++i)
+                table->push_back(morpher.getMorphedParams(range.start + static_cast<float>(i) * range.interval));
+            return std::shared_ptr<const std::vector<DiodeParams>>(std::move(table));
+        });
+    }
+}
+
+MT2ParameterSnapshot::~MT2ParameterSnapshot()
+{
+    for (auto* param : mParams)
+        if (param != nullptr)
+            param->removeListener(this);
+}
+
+void MT2ParameterSnapshot::parameterValueChanged(int parameterIndex, float)
+{
+    if (parameterIndex < 0 || parameterIndex >= static_cast<int>(mIndexToParam.size()))
+        return;
+
+    const int p = mIndexToParam[static_cast<size_t>(parameterIndex)];
+    if (p >= 0)
+        mDirty.fetch_or(bit(static_cast<Param>(p)), std::memory_order_release);
+}
+
+int MT2ParameterSnapshot::stepIndex(Param p, float value) const
+{
+    const auto& range = mParams[static_cast<size_t>(p)]->getNormalisableRange();
+    if (range.interval <= 0.0f) return 0;
+    return juce::jlimit(0, numSteps(range) - 1, juce::roundToInt((value - range.start) / range.interval));
+}
+
+juce::uint32 MT2ParameterSnapshot::update()
+{
+    const juce::uint32 dirty = mDirty.exchange(0, std::memory_order_acquire);
+    if (dirty == 0)
+        return 0;
+
+    // Read the parameter's own value: it is stored before listeners run,
+    // whereas the APVTS raw value is itself updated by a listener
+    auto raw = [this](Param p, float fallback) {
+        auto* param = mParams[static_cast<size_t>(p)];
+        return param != nullptr ? param->convertFrom0to1(param->getValue()) : fallback;
+    };
+    auto rawInt = [&raw](Param p, float fallback) { return static_cast<int>(std::round(raw(p, fallback))); };
+
+    auto& v = mValues;
+
+    if (dirty & bit(Dist)) {
+        const float dist = raw(Dist, 0.5f);
+        v.gain = mGainTable == nullptr ? distToGain(dist) : (*mGainTable)[static_cast<size_t>(stepIndex(Dist, dist))];
+    }
+
+    // Map level parameter (0.0~1.0) to output level
+    if (dirty & bit(Level))
+        v.outputLevel = raw(Level, 0.5f) * 2.0;
+
+    if (dirty & diodeBits) {
+        // Both morph parameters share one range, so they share the table
+        auto morphed = [this](float morph) {
+            return mDiodeTable == nullptr ? DiodeMorpher().getMorphedParams(morph)
+                                          : (*mDiodeTable)[static_cast<size_t>(stepIndex(DiodeMorph, morph))];
+        };
+        v.stage1 = morphed(raw(DiodeMorph, 0.0f));
+        v.stage2 = raw(DiodeLink, 1.0f) > 0.5f ? v.stage1 : morphed(raw(DiodeMorph2, 0.0f));
+    }
+
+    if (dirty & eqBits) {
+        v.eqLow = raw(EqLow, 0.5f);
+        v.eqMid = raw(EqMid, 0.5f);
+        v.eqMidFreq = raw(EqMidFreq, 0.5f);
+        v.eqMidQ = raw(EqMidQ, 0.3f);
+        v.eqHigh = raw(EqHigh, 0.5f);
+    }
+
+    if (dirty & bit(ClipMode))       v.clipMode = rawInt(ClipMode, 0.0f);
+    if (dirty & bit(OutSat))         v.satAmount = raw(OutSat, 0.0f);
+    if (dirty & bit(SatPos))         v.satPosition = rawInt(SatPos, 1.0f);
+    if (dirty & bit(DiodeSolver))    v.diodeSolver = rawInt(DiodeSolver, 1.0f);
+    if (dirty & bit(SolverQuality))  v.solverQuality = rawInt(SolverQuality, 1.0f);
+    if (dirty & bit(ClipAdaa))       v.clipAdaa = raw(ClipAdaa, 1.0f) > 0.5f;
+    if (dirty & bit(CircuitModel))   v.circuitModel = raw(CircuitModel, 0.0f) > 0.5f;
+    if (dirty & bit(OsFactor))       v.osFactorLog2 = rawInt(OsFactor, 1.0f);
+    if (dirty & bit(OsPhase))        v.osMinPhase = raw(OsPhase, 0.0f) > 0.5f;
+
+    return dirty;
+}
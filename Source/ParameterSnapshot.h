@@ -0,0 +1,86 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "DSP/DiodeMorpher.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** Audio-thread view of the plugin parameters.
+
+    - Parameter pointers are looked up by ID once, in the constructor.
+    - Every parameter has a dirty bit. A listener sets it from whatever
+      thread changes the value (one atomic OR); update() swaps the whole
+      mask out once per block and only touches what changed, so a block
+      with no parameter change costs one atomic exchange.
+    - Derived values that need pow or the diode morph are tabulated per
+      parameter step when the snapshot is built (message thread), once per
+      process (SharedTables). The tables are immutable, so the audio thread
+      reads them without locks.
+*/
+class MT2ParameterSnapshot : private juce::AudioProcessorParameter::Listener {
+public:
+    enum Param {
+        Dist, Level, DiodeMorph, DiodeLink, DiodeMorph2,
+        EqLow, EqMid, EqMidFreq, EqMidQ, EqHigh,
+        ClipMode, OutSat, SatPos, DiodeSolver, SolverQuality, ClipAdaa, CircuitModel, OsFactor, OsPhase,
+        NumParams
+    };
+
+    static constexpr juce::uint32 bit(Param p) { return juce::uint32 { 1 } << p; }
+
+    // Spelled out: bit() cannot be used in a constant expression inside its own class
+    static constexpr juce::uint32 diodeBits = (1u << DiodeMorph) | (1u << DiodeLink) | (1u << DiodeMorph2);
+    static constexpr juce::uint32 eqBits = (1u << EqLow) | (1u << EqMid) | (1u << EqMidFreq) | (1u << EqMidQ) | (1u << EqHigh);
+    static constexpr juce::uint32 solverBits = (1u << DiodeSolver) | (1u << SolverQuality);
+    static constexpr juce::uint32 oversamplingBits = (1u << OsFactor) | (1u << OsPhase);
+
+    /** Values ready for the DSP */
+    struct Values {
+        double gain = 1.0;            // dist → 5.6 … 200
+        double outputLevel = 1.0;     // level → 0 … 2
+        DiodeParams stage1 { 0.0, 1.0, false };
+        DiodeParams stage2 { 0.0, 1.0, false };
+        float eqLow = 0.5f, eqMid = 0.5f, eqMidFreq = 0.5f, eqMidQ = 0.3f, eqHigh = 0.5f;
+        int clipMode = 0;
+        int satPosition = 1;          // 0 = Pre, 1 = Post, 2 = Off
+        float satAmount = 0.0f;
+        int diodeSolver = 1;          // 0 = Exact, 1 = Table, 2 = Omega
+        int solverQuality = 1;        // 0 = Eco, 1 = Normal, 2 = High
+        bool clipAdaa = true;
+        bool circuitModel = false;
+        int osFactorLog2 = 1;
+        bool osMinPhase = false;
+    };
+
+    explicit MT2ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts);
+    ~MT2ParameterSnapshot() override;
+
+    /** Audio thread: refresh the values whose parameters changed.
+        Returns the dirty bits that were handled (0 = nothing changed). */
+    juce::uint32 update();
+
+    const Values& get() const { return mValues; }
+
+    /** Force the next update() to refresh everything (e.g. from prepareToPlay). */
+    void markAllDirty() { mDirty.store(bit(NumParams) - 1, std::memory_order_release); }
+
+private:
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+
+    /** Parameter value → index into a per-step table */
+    int stepIndex(Param p, float value) const;
+
+    std::array<juce::RangedAudioParameter*, NumParams> mParams {};
+    std::vector<int> mIndexToParam;   // AudioProcessorParameter index → Param (or -1)
+
+    std::atomic<juce::uint32> mDirty { bit(NumParams) - 1 };
+    Values mValues;
+
+    // Looked up in the constructor (shared by every instance), read-only afterwards
+    std::shared_ptr<const std::vector<double>> mGainTable;          // per dist step
+    std::shared_ptr<const std::vector<DiodeParams>> mDiodeTable;    // per diode morph step
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MT2ParameterSnapshot)
+};
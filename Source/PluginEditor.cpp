@@ -3,7 +3,8 @@
 MT2PluginEditor::MT2PluginEditor(MT2Plugin& p)
     : AudioProcessorEditor(p),
       processorRef(p),
-      apvts(p.apvts)
+      apvts(p.apvts),
+      analyzerView(p.getAnalyzerFeed())
 {
     // Setup all sliders
     for (auto* slider : std::vector<juce::Slider*>{
@@ -17,7 +18,8 @@ MT2PluginEditor::MT2PluginEditor(MT2Plugin& p)
     }
 
     // Clip Mode and Sat Position - discrete sliders with value display
-    for (auto* slider : std::vector<juce::Slider*>{&clipModeSlider, &satPosSlider})
+    for (auto* slider : std::vector<juce::Slider*>{&clipModeSlider, &satPosSlider, &diodeSolverSlider,
+                                                  &osFactorSlider, &osPhaseSlider, &solverQualitySlider})
     {
         slider->setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
         slider->setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
@@ -41,6 +43,24 @@ MT2PluginEditor::MT2PluginEditor(MT2Plugin& p)
     };
     satPosSlider.setValue(1.0);
 
+    diodeSolverSlider.textFromValueFunction = [](double value) {
+        const char* names[] = {"Exact", "Table", "Omega"};
+        return juce::String(names[juce::jlimit(0, 2, (int)std::round(value))]);
+    };
+
+    solverQualitySlider.textFromValueFunction = [](double value) {
+        const char* names[] = {"Eco", "Normal", "High"};
+        return juce::String(names[juce::jlimit(0, 2, (int)std::round(value))]);
+    };
+
+    osFactorSlider.textFromValueFunction = [](double value) {
+        return juce::String(1 << juce::jlimit(0, 3, (int)std::round(value))) + "x";
+    };
+
+    osPhaseSlider.textFromValueFunction = [](double value) {
+        return juce::String(std::round(value) < 0.5 ? "Linear" : "MinPh");
+    };
+
     outSatSlider.textFromValueFunction = [](double value) {
         if (value < 0.01) return juce::String("OFF");
         return juce::String((int)(value * 100)) + "%";
@@ -57,21 +77,40 @@ MT2PluginEditor::MT2PluginEditor(MT2Plugin& p)
     diodeMorphSlider.textFromValueFunction = diodeTextFromValue;
     diodeMorph2Slider.textFromValueFunction = diodeTextFromValue;
 
-    // Start timer for diode link functionality
-    startTimerHz(30);  // Check 30 times per second
+    // Polls the load meter and the paint statistics; the diode link is
+    // driven by parameter listeners and an AsyncUpdater, not by this timer
+    startTimerHz(30);  // Load meter refresh rate; paint stats once a second
 
     // Toggle button
     diodeLinkButton.setButtonText("Link");
     addAndMakeVisible(diodeLinkButton);
 
+    // ADAA toggle (static clip modes only)
+    clipAdaaButton.setButtonText("ADAA");
+    addAndMakeVisible(clipAdaaButton);
+
+    circuitModelButton.setButtonText("Circuit");
+    addAndMakeVisible(circuitModelButton);
+
     // Labels
     for (auto* label : std::vector<juce::Label*>{
          &distLabel, &levelLabel, &diodeMorphLabel, &diodeMorph2Label,
          &eqLowLabel, &eqMidLabel, &eqMidFreqLabel, &eqMidQLabel, &eqHighLabel,
-         &clipModeLabel, &satPosLabel, &outSatLabel})
+         &clipModeLabel, &satPosLabel, &outSatLabel, &diodeSolverLabel,
+         &osFactorLabel, &osPhaseLabel, &solverQualityLabel})
     {
         label->setJustificationType(juce::Justification::centred);
         label->setFont(juce::Font(11.0f));
+        label->setBufferedToImage(true);   // static text: render once, then blit
+        addAndMakeVisible(label);
+    }
+
+    loadStatsLabel.setJustificationType(juce::Justification::centredLeft);
+    solverStatsLabel.setJustificationType(juce::Justification::centredRight);
+    paintStatsLabel.setJustificationType(juce::Justification::centredRight);
+    for (auto* label : { &loadStatsLabel, &solverStatsLabel, &paintStatsLabel }) {
+        label->setFont(juce::Font(11.0f));
+        label->setColour(juce::Label::textColourId, juce::Colours::lightgrey);
         addAndMakeVisible(label);
     }
 
@@ -80,6 +119,8 @@ MT2PluginEditor::MT2PluginEditor(MT2Plugin& p)
     levelAttachment     = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "level", levelSlider);
     diodeMorphAttachment= std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "diode_morph", diodeMorphSlider);
     diodeLinkAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "diode_link", diodeLinkButton);
+    clipAdaaAttachment  = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "clip_adaa", clipAdaaButton);
+    circuitModelAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(apvts, "circuit_model", circuitModelButton);
     diodeMorph2Attachment=std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "diode_morph_2", diodeMorph2Slider);
     eqLowAttachment     = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "eq_low", eqLowSlider);
     eqMidAttachment     = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "eq_mid", eqMidSlider);
@@ -89,39 +130,131 @@ MT2PluginEditor::MT2PluginEditor(MT2Plugin& p)
     clipModeAttachment  = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "clip_mode", clipModeSlider);
     satPosAttachment    = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "sat_pos", satPosSlider);
     outSatAttachment    = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "out_sat", outSatSlider);
+    diodeSolverAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "diode_solver", diodeSolverSlider);
+    solverQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "solver_quality", solverQualitySlider);
+    osFactorAttachment  = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "os_factor", osFactorSlider);
+    osPhaseAttachment   = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "os_phase", osPhaseSlider);
+
+    addAndMakeVisible(analyzerView);
 
-    setSize(540, 460);
+    // The background covers everything: nothing behind the editor needs painting
+    setOpaque(true);
+    setSize(540, 620);
+
+    // Diode link follows the parameters instead of being polled
+    apvts.addParameterListener("diode_link", this);
+    apvts.addParameterListener("diode_morph", this);
+    updateDiodeLink();
+
+    // The processor only meters while an editor is open
+    processorRef.getLoadMeter().attach();
 }
 
 MT2PluginEditor::~MT2PluginEditor()
 {
     stopTimer();
+    apvts.removeParameterListener("diode_link", this);
+    apvts.removeParameterListener("diode_morph", this);
+    cancelPendingUpdate();
+    processorRef.getLoadMeter().detach();
 }
 
-void MT2PluginEditor::timerCallback()
+void MT2PluginEditor::parameterChanged(const juce::String&, float)
+{
+    // May be the audio thread (automation): only flag the update
+    triggerAsyncUpdate();
+}
+
+void MT2PluginEditor::handleAsyncUpdate()
+{
+    updateDiodeLink();
+}
+
+void MT2PluginEditor::updateDiodeLink()
 {
-    // Check if link is enabled
     auto* diodeLinkParam = apvts.getParameter("diode_link");
     if (!diodeLinkParam) return;
 
-    bool isLinked = diodeLinkParam->getValue() > 0.5f;
+    const bool isLinked = diodeLinkParam->getValue() > 0.5f;
 
     if (isLinked) {
-        // Sync diode2 to diode1
-        auto* diodeMorphParam = apvts.getParameter("diode_morph");
-        if (diodeMorphParam) {
-            float value = diodeMorphParam->getValue();
-            diodeMorph2Slider.setValue(value, juce::dontSendNotification);
-        }
+        // Diode2 shows diode1 (the snapshot applies the link to the DSP)
+        if (auto* diodeMorphParam = apvts.getParameter("diode_morph"))
+            diodeMorph2Slider.setValue(diodeMorphParam->getValue(), juce::dontSendNotification);
     }
 
-    // Enable/disable diode2 based on link state
+    // Setters do nothing (and repaint nothing) when the state is unchanged
     diodeMorph2Slider.setEnabled(!isLinked);
     diodeMorph2Label.setEnabled(!isLinked);
 }
 
-void MT2PluginEditor::paint(juce::Graphics& g)
+void MT2PluginEditor::updateLoadMeter()
+{
+    MT2LoadMeter::Report report;
+    if (!processorRef.getLoadMeter().read(report))
+        return;   // no block since the last tick (transport stopped)
+
+    const auto last = std::exchange(lastLoadReport, report);
+    if (!std::exchange(hasLoadReport, true))
+        return;   // first report: nothing to diff against yet
+
+    // Load = time spent / audio time processed, since the previous tick
+    const double audioSeconds = report.audioSeconds - last.audioSeconds;
+    if (audioSeconds <= 0.0) return;
+
+    dspLoad = static_cast<float>((report.busySeconds - last.busySeconds) / audioSeconds);
+    dspPeakLoad = static_cast<float>(report.peakLoad);
+
+    juce::String stages;
+    const char* names[] = { "Pre", "Gain", "Tone", "Post" };
+    for (size_t s = 0; s < MT2LoadMeter::NumStages; ++s) {
+        const double share = (report.stageSeconds[s] - last.stageSeconds[s]) / audioSeconds;
+        stages << names[s] << " " << juce::String(share * 100.0, 1) << "  ";
+    }
+    loadStatsLabel.setText(stages.trimEnd() + " %", juce::dontSendNotification);
+
+    const auto solves = report.solves - last.solves;
+    solverStatsLabel.setText(solves > 0
+                                 ? "Iter avg " + juce::String(static_cast<double>(report.iterations - last.iterations)
+                                                                  / static_cast<double>(solves), 2)
+                                       + " / max " + juce::String(report.maxIterations)
+                                 : juce::String(),
+                             juce::dontSendNotification);
+
+    // Repaint the bar only when what it shows changes
+    auto text = "DSP " + juce::String(dspLoad * 100.0f, 1) + "%";
+    const int peak = juce::roundToInt(loadMeterBounds.getWidth() * juce::jlimit(0.0f, 1.0f, dspPeakLoad));
+    if (text != loadText || peak != peakPixel) {
+        loadText = std::move(text);
+        peakPixel = peak;
+        repaint(loadMeterBounds);
+    }
+}
+
+void MT2PluginEditor::timerCallback()
+{
+    updateLoadMeter();
+
+    // Paint time, once a second (updating it more often would itself cause repaints)
+    if (++paintStatsTicks >= 30) {
+        paintStatsTicks = 0;
+        if (paintCount > 0)
+            paintStatsLabel.setText("UI " + juce::String(1000.0 * paintSeconds / paintCount, 2) + " ms",
+                                    juce::dontSendNotification);
+        paintSeconds = 0.0;
+        paintCount = 0;
+    }
+}
+
+void MT2PluginEditor::renderBackground(float scale)
 {
+    // Rendered at the display scale so the title stays sharp on HiDPI screens
+    backgroundScale = scale;
+    backgroundImage = juce::Image(juce::Image::RGB, juce::roundToInt(getWidth() * scale),
+                                  juce::roundToInt(getHeight() * scale), false);
+    juce::Graphics g(backgroundImage);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     g.fillAll(juce::Colours::darkgrey);
 
     g.setColour(juce::Colours::white);
@@ -132,10 +265,46 @@ void MT2PluginEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colours::lightgrey);
     g.drawHorizontalLine(165, 0, getWidth());  // After Dist section
     g.drawHorizontalLine(295, 0, getWidth());  // After EQ section
+    g.drawHorizontalLine(460, 0, getWidth());  // After status strip
+}
+
+void MT2PluginEditor::paint(juce::Graphics& g)
+{
+    paintStartTicks = juce::Time::getHighResolutionTicks();
+
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!backgroundImage.isValid() || scale != backgroundScale)
+        renderBackground(scale);
+    g.drawImageTransformed(backgroundImage, juce::AffineTransform::scale(1.0f / scale));
+
+    // DSP load: bar = average since the last tick, tick mark = worst block
+    if (!loadMeterBounds.isEmpty()) {
+        auto bar = loadMeterBounds.toFloat();
+        g.setColour(juce::Colours::black.withAlpha(0.4f));
+        g.fillRect(bar);
+
+        const float load = juce::jlimit(0.0f, 1.0f, dspLoad);
+        g.setColour(load < 0.5f ? juce::Colours::limegreen : load < 0.8f ? juce::Colours::orange : juce::Colours::red);
+        g.fillRect(bar.withWidth(bar.getWidth() * load));
+
+        g.setColour(juce::Colours::white);
+        g.drawVerticalLine(loadMeterBounds.getX() + peakPixel, bar.getY(), bar.getBottom());
+
+        g.setFont(juce::Font(11.0f));
+        g.drawText(loadText, loadMeterBounds, juce::Justification::centred);
+    }
+}
+
+void MT2PluginEditor::paintOverChildren(juce::Graphics&)
+{
+    paintSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - paintStartTicks);
+    ++paintCount;
 }
 
 void MT2PluginEditor::resized()
 {
+    backgroundImage = {};   // re-rendered at the new size on the next paint
+
     auto area = getLocalBounds();
     area.removeFromTop(35); // title space
 
@@ -167,6 +336,16 @@ void MT2PluginEditor::resized()
     diodeLinkButton.setBounds(xPos, yPos + 32, 50, 22);
     diodeMorph2Slider.setBounds(xPos + 55, yPos, knobWidth, knobHeight);
     diodeMorph2Label.setBounds(xPos + 55, yPos + knobHeight, knobWidth, labelHeight);
+    xPos += 55 + knobWidth + gap;
+
+    // ADAA / circuit model toggles
+    clipAdaaButton.setBounds(xPos, yPos + 32, 70, 22);
+    circuitModelButton.setBounds(xPos, yPos + 60, 70, 22);
+    xPos += 70 + gap;
+
+    // Diode solver quality
+    solverQualitySlider.setBounds(xPos, yPos, knobWidth, knobHeight);
+    solverQualityLabel.setBounds(xPos, yPos + knobHeight, knobWidth, labelHeight);
 
     // EQ section (middle) - 5 knobs
     auto eqArea = area.removeFromTop(130);
@@ -194,11 +373,11 @@ void MT2PluginEditor::resized()
     eqHighSlider.setBounds(xPos, yPos, knobWidth, knobHeight);
     eqHighLabel.setBounds(xPos, yPos + knobHeight, knobWidth, labelHeight);
 
-    // Output section (bottom) - 3 knobs
+    // Output section (bottom) - 6 knobs
     auto outArea = area.removeFromTop(130);
     auto outKnobs = outArea.reduced(8);
 
-    xPos = outKnobs.getX() + 35;
+    xPos = outKnobs.getX();
     yPos = outKnobs.getY() + 5;
 
     clipModeSlider.setBounds(xPos, yPos, knobWidth, knobHeight);
@@ -211,4 +390,27 @@ void MT2PluginEditor::resized()
 
     outSatSlider.setBounds(xPos, yPos, knobWidth, knobHeight);
     outSatLabel.setBounds(xPos, yPos + knobHeight, knobWidth, labelHeight);
+    xPos += knobWidth + gap;
+
+    diodeSolverSlider.setBounds(xPos, yPos, knobWidth, knobHeight);
+    diodeSolverLabel.setBounds(xPos, yPos + knobHeight, knobWidth, labelHeight);
+    xPos += knobWidth + gap;
+
+    osFactorSlider.setBounds(xPos, yPos, knobWidth, knobHeight);
+    osFactorLabel.setBounds(xPos, yPos + knobHeight, knobWidth, labelHeight);
+    xPos += knobWidth + gap;
+
+    osPhaseSlider.setBounds(xPos, yPos, knobWidth, knobHeight);
+    osPhaseLabel.setBounds(xPos, yPos + knobHeight, knobWidth, labelHeight);
+
+    // Status strip (bottom): load bar | stage breakdown | solver iterations
+    auto strip = area.removeFromTop(35).reduced(8, 6);
+    loadMeterBounds = strip.removeFromLeft(100);
+    strip.removeFromLeft(gap);
+    loadStatsLabel.setBounds(strip.removeFromLeft(230));
+    paintStatsLabel.setBounds(strip.removeFromRight(70));
+    solverStatsLabel.setBounds(strip);
+
+    // Analyzer (bottom)
+    analyzerView.setBounds(area.reduced(8, 4));
 }
@@ -1,17 +1,30 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "PluginProcessor.h"
+#include "AnalyzerView.h"
 
-class MT2PluginEditor : public juce::AudioProcessorEditor, public juce::Timer {
+class MT2PluginEditor : public juce::AudioProcessorEditor, public juce::Timer,
+                        private juce::AudioProcessorValueTreeState::Listener, private juce::AsyncUpdater {
 public:
     explicit MT2PluginEditor(MT2Plugin&);
     ~MT2PluginEditor() override;
 
     void paint(juce::Graphics&) override;
+    void paintOverChildren(juce::Graphics&) override;
     void resized() override;
     void timerCallback() override;
 
 private:
+    // Diode link: parameter changes (any thread) → async update on the message thread
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void updateDiodeLink();
+
+    // Static background (fill, title, dividers), rendered once per size and display scale
+    void renderBackground(float scale);
+    juce::Image backgroundImage;
+    float backgroundScale = 0.0f;
+
     MT2Plugin& processorRef;
     juce::AudioProcessorValueTreeState& apvts;
 
@@ -21,6 +34,9 @@ private:
     juce::Slider diodeMorphSlider;
     juce::ToggleButton diodeLinkButton{"Link"};
     juce::Slider diodeMorph2Slider;
+    juce::ToggleButton clipAdaaButton{"ADAA"};
+    juce::ToggleButton circuitModelButton{"Circuit"};
+    juce::Slider solverQualitySlider;
 
     // EQ section
     juce::Slider eqLowSlider;
@@ -33,6 +49,9 @@ private:
     juce::Slider clipModeSlider;
     juce::Slider satPosSlider;
     juce::Slider outSatSlider;
+    juce::Slider diodeSolverSlider;
+    juce::Slider osFactorSlider;
+    juce::Slider osPhaseSlider;
 
     // Attachments (connect UI to parameters)
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distAttachment;
@@ -40,6 +59,9 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> diodeMorphAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> diodeLinkAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> diodeMorph2Attachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> clipAdaaAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> circuitModelAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> solverQualityAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqLowAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqMidAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqMidFreqAttachment;
@@ -48,6 +70,9 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> clipModeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> satPosAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outSatAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> diodeSolverAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> osFactorAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> osPhaseAttachment;
 
     // Labels
     juce::Label distLabel{"Dist", "Dist"};
@@ -62,6 +87,35 @@ private:
     juce::Label clipModeLabel{"Clip", "Clip Mode"};
     juce::Label satPosLabel{"Pos", "Sat Pos"};
     juce::Label outSatLabel{"Sat", "Sat"};
+    juce::Label diodeSolverLabel{"Solver", "Solver"};
+    juce::Label osFactorLabel{"OS", "Oversample"};
+    juce::Label osPhaseLabel{"OSPhase", "OS Phase"};
+    juce::Label solverQualityLabel{"Quality", "Quality"};
+
+    // Status strip: DSP load bar, per-stage breakdown and diode solver
+    // iterations, each over the time since the previous timer tick
+    juce::Rectangle<int> loadMeterBounds;
+    juce::Label loadStatsLabel;
+    juce::Label solverStatsLabel;
+    MT2LoadMeter::Report lastLoadReport;
+    bool hasLoadReport = false;
+    float dspLoad = 0.0f;
+    float dspPeakLoad = 0.0f;
+    juce::String loadText;        // what the bar shows; repainted only when it changes
+    int peakPixel = -1;
+
+    void updateLoadMeter();
+
+    // Paint time of the editor and its children (paint → paintOverChildren),
+    // shown as a once-per-second average
+    juce::Label paintStatsLabel;
+    juce::int64 paintStartTicks = 0;
+    double paintSeconds = 0.0;
+    int paintCount = 0;
+    int paintStatsTicks = 0;
+
+    // Output spectrum and oscilloscope (below the status strip)
+    MT2AnalyzerView analyzerView;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MT2PluginEditor)
 };
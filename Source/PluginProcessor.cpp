@@ -1,70 +1,136 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "TableCache.h"
+#include <algorithm>
 #include <cmath>
 
-namespace {
-    // Helper: Apply tanh saturation to double buffer
-    void applySaturationDouble(juce::AudioBuffer<double>& buf, float amount)
-    {
-        if (amount < 0.01f) return;
-        const int numChannels = buf.getNumChannels();
-        const int numSamples = buf.getNumSamples();
-        double drive = 1.0 + static_cast<double>(amount) * 3.0;
-        double norm = 1.0 / std::tanh(drive);
-
-        for (int ch = 0; ch < numChannels; ++ch) {
-            auto* data = buf.getWritePointer(ch);
-            for (int i = 0; i < numSamples; ++i) {
-                data[i] = std::tanh(data[i] * drive) * norm;
-            }
-        }
-    }
-
-    // Helper: Apply tanh saturation to float buffer
-    void applySaturationFloat(juce::AudioBuffer<float>& buf, float amount)
-    {
-        if (amount < 0.01f) return;
-        const int numChannels = buf.getNumChannels();
-        const int numSamples = buf.getNumSamples();
-        double drive = 1.0 + static_cast<double>(amount) * 3.0;
-        double norm = 1.0 / std::tanh(drive);
-
-        for (int ch = 0; ch < numChannels; ++ch) {
-            auto* data = buf.getWritePointer(ch);
-            for (int i = 0; i < numSamples; ++i) {
-                double driven = static_cast<double>(data[i]) * drive;
-                data[i] = static_cast<float>(std::tanh(driven) * norm);
-            }
-        }
-    }
-}
-
 MT2Plugin::MT2Plugin()
     : AudioProcessor(BusesProperties()
           .withInput("Input", juce::AudioChannelSet::stereo(), true)
           .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
       apvts(*this, nullptr, "PARAMETERS", MT2Params::createLayout())
 {
-    clipMode = apvts.getRawParameterValue("clip_mode");
-    outSat = apvts.getRawParameterValue("out_sat");
-    satPos = apvts.getRawParameterValue("sat_pos");
 }
 
 void MT2Plugin::prepareToPlay(double sampleRate, int maxSamplesPerBlock)
 {
-    // Prepare DSP modules (no oversampling for now due to auval issues)
-    mGainStage.prepare(sampleRate);
-    mToneStack.prepare(sampleRate);
+    mSampleRate = sampleRate;
+
+    // Read the current parameter values for the oversampling setup
+    mParameters.markAllDirty();
+    mParameters.update();
+    const auto& params = mParameters.get();
+
+    // One channel group per lane width (see forEachChain); the layout only
+    // changes while the plugin is not processing
+    const int numChannels = std::max(1, std::min(getMainBusNumInputChannels(), getMainBusNumOutputChannels()));
+    if (numChannels != mNumChainChannels)
+        createChains(numChannels);
+
+    // The diode table is mapped from the cache file or built on a background
+    // thread; until it is ready the gain stage solves exactly. Offline
+    // renders wait for it so that every bounce runs the same solver.
+    auto diodeTable = MT2TableCache::getDiodeTable();
+    if (isNonRealtime())
+        diodeTable->wait();
+
+    // Offline bounces get the render profile. Its filters change the
+    // latency, so they only switch here, where the stream restarts anyway;
+    // the solver part follows isNonRealtime() per block (see applySolver).
+    mRenderProfile = isNonRealtime();
+
+    // Prepare DSP modules; the gain stage is prepared at the oversampled rate,
+    // and switching the factor later re-prepares it from processBlock
+    mToneStackTailSamples = 0.0;
+    forEachChain([&](auto& chain, int, int) {
+        if (!chain.getGainStage().hasDiodeTable())
+            chain.getGainStage().setPendingDiodeTable(diodeTable);
+        chain.setOversamplingQuality(mRenderProfile);
+        chain.prepare(sampleRate, maxSamplesPerBlock);
+        mToneStackTailSamples = std::max(mToneStackTailSamples, chain.getToneStack().getMaxTailSamples(kTailDecayDb));
+    });
+    updateOversampling(getOversamplingFactorLog2(params), params.osMinPhase);
+    mAnalyzerFeed.prepare(sampleRate);
+
+    // Every setting is pushed to the freshly prepared DSP on the first block
+    mParameters.markAllDirty();
 
     // Prepare smoothed values
     mSmoothedGain.reset(sampleRate, 0.01);
     mSmoothedLevel.reset(sampleRate, 0.01);
+}
+
+void MT2Plugin::createChains(int numChannels)
+{
+    mQuadChains.clear();
+    mPairChain.reset();
+    mSingleChain.reset();
+
+    int remaining = numChannels;
+    for (; remaining >= 4; remaining -= 4)
+        mQuadChains.push_back(std::make_unique<MT2ChannelChain<simd::Double4>>());
+    if (remaining >= 2)
+        mPairChain = std::make_unique<MT2ChannelChain<simd::Double2>>();
+    if (remaining % 2 == 1)
+        mSingleChain = std::make_unique<MT2ChannelChain<double>>();
+
+    mNumChainChannels = numChannels;
+}
+
+void MT2Plugin::updateOversampling(int factorLog2, bool minimumPhase)
+{
+    // Once every factor's rate is preloaded (prepareToPlay) this neither
+    // allocates nor locks, so it is also used from processBlock when the
+    // factor changes
+    int latency = 0;
+    forEachChain([&](auto& chain, int, int) {
+        chain.setOversampling(factorLog2, minimumPhase);
+        latency = chain.getOversampler().getLatencySamples();
+    });
+    mOversamplingFactorLog2 = factorLog2;
+    mOversamplingMinPhase = minimumPhase;
+
+    // Hosts pick up the new value through audioProcessorChanged
+    setLatencySamples(latency);
+    updateTail();
+}
 
-    // Prepare double buffer (always 2 channels for stereo)
-    mBufferDouble.setSize(2, maxSamplesPerBlock);
+int MT2Plugin::getOversamplingFactorLog2(const MT2ParameterSnapshot::Values& params) const
+{
+    return mRenderProfile ? std::max(params.osFactorLog2, kRenderMinOsFactorLog2) : params.osFactorLog2;
+}
 
-    // Report latency (no oversampling = 0 latency)
-    setLatencySamples(0);
+void MT2Plugin::applySolver(const MT2ParameterSnapshot::Values& params, bool rendering)
+{
+    // Rendering always solves exactly to the tightest tolerance. Both
+    // profiles solve the same equation (the table is within 1.5 µV of the
+    // exact solution), so switching mid-stream is seamless.
+    const auto solver = rendering ? DiodeFeedbackClipper::Solver::Newton
+                                  : static_cast<DiodeFeedbackClipper::Solver>(params.diodeSolver);
+    const auto quality = rendering ? DiodeFeedbackClipper::Quality::High
+                                   : static_cast<DiodeFeedbackClipper::Quality>(params.solverQuality);
+    forEachChain([&](auto& chain, int, int) {
+        chain.getGainStage().setDiodeSolver(solver);
+        chain.getGainStage().setDiodeQuality(quality);
+    });
+    mSolverRendering = rendering;
+}
+
+void MT2Plugin::updateTail()
+{
+    // Oversampling filters and interstage filters at the current factor
+    // (every group runs the same configuration)
+    double chainTail = 0.0;
+    forEachChain([&](auto& chain, int, int) {
+        const auto& os = chain.getOversampler();
+        chainTail = os.getTailSamples(kTailDecayDb) + chain.getGainStage().getTailSamples(kTailDecayDb) / os.getFactor();
+    });
+
+    // The reported tail covers the tone stack's longest ringing so hosts can
+    // rely on it; sleeping only needs the output to stay quiet for a while
+    // (50 ms catches a decaying tone stack resonance between its peaks)
+    mTailSeconds.store((chainTail + mToneStackTailSamples) / mSampleRate, std::memory_order_relaxed);
+    mSleepHoldSamples = static_cast<int>(chainTail + 0.05 * mSampleRate);
 }
 
 void MT2Plugin::releaseResources()
@@ -73,153 +139,180 @@ void MT2Plugin::releaseResources()
 
 void MT2Plugin::reset()
 {
-    mGainStage.reset();
-    mToneStack.reset();
+    forEachChain([](auto& chain, int, int) { chain.reset(); });
     mSmoothedGain.reset(0.0);
     mSmoothedLevel.reset(0.0);
+    mQuietSamples = 0;
+    mSleeping = false;
 }
 
 void MT2Plugin::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
-    juce::ScopedNoDenormals noDenormals;
-
-    // Get parameter values (atomic read)
-    auto* distParam = apvts.getRawParameterValue("dist");
-    auto* levelParam = apvts.getRawParameterValue("level");
-    auto* diodeMorphParam = apvts.getRawParameterValue("diode_morph");
-    auto* diodeLinkParam = apvts.getRawParameterValue("diode_link");
-    auto* diodeMorph2Param = apvts.getRawParameterValue("diode_morph_2");
-    auto* eqLowParam = apvts.getRawParameterValue("eq_low");
-    auto* eqMidParam = apvts.getRawParameterValue("eq_mid");
-    auto* eqMidFreqParam = apvts.getRawParameterValue("eq_mid_freq");
-    auto* eqMidQParam = apvts.getRawParameterValue("eq_mid_q");
-    auto* eqHighParam = apvts.getRawParameterValue("eq_high");
-
-    // Map dist parameter (0.0~1.0) to gain (5.6~200)
-    float distValue = distParam ? distParam->load() : 0.5f;
-    double gain = 5.6 * std::pow(200.0 / 5.6, distValue);
-
-    // Map level parameter (0.0~1.0) to output level
-    float levelValue = levelParam ? levelParam->load() : 0.5f;
-    double outputLevel = levelValue * 2.0;
-
-    // Saturator position and amount
-    int satPosition = (satPos != nullptr) ? (int)std::round(satPos->load()) : 1;  // 0=Pre, 1=Post, 2=Off
-    float satAmount = (outSat != nullptr) ? outSat->load() : 0.0f;
-
-    // Update smoothed values
-    mSmoothedGain.setTargetValue(gain);
-    mSmoothedLevel.setTargetValue(outputLevel);
+    processSamples(buffer);
+}
 
-    // Update diode parameters
-    float diodeMorph = diodeMorphParam ? diodeMorphParam->load() : 0.0f;
-    bool diodeLink = diodeLinkParam ? diodeLinkParam->load() > 0.5f : true;
-    float diodeMorph2 = diodeMorph2Param ? diodeMorph2Param->load() : 0.0f;
+void MT2Plugin::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processSamples(buffer);
+}
 
-    auto stage1Params = mDiodeMorpher.getMorphedParams(diodeMorph);
-    mGainStage.setStage1Diode(stage1Params.is, stage1Params.n, stage1Params.noClip);
+template <typename FloatType>
+void MT2Plugin::processSamples(juce::AudioBuffer<FloatType>& buffer)
+{
+    juce::ScopedNoDenormals noDenormals;
+    MT2LoadMeter::Block meter(mLoadMeter, buffer.getNumSamples(), mSampleRate);
+
+    // Refresh only what changed since the last block (nothing, most of the time)
+    using Snapshot = MT2ParameterSnapshot;
+    const juce::uint32 changed = mParameters.update();
+    const auto& params = mParameters.get();
+
+    // Smoothed gain (5.6~200) and output level; the gain smoother advances once per block
+    if (changed & Snapshot::bit(Snapshot::Dist))
+        mSmoothedGain.setTargetValue(params.gain);
+    if (changed & Snapshot::bit(Snapshot::Level))
+        mSmoothedLevel.setTargetValue(params.outputLevel);
+
+    const double gain = mSmoothedGain.getNextValue();
+    forEachChain([&](auto& chain, int, int) { chain.getGainStage().setGain(gain); });
+
+    // Diode parameters (stage 2 follows stage 1 when linked)
+    if (changed & Snapshot::diodeBits) {
+        forEachChain([&](auto& chain, int, int) {
+            chain.getGainStage().setStage1Diode(params.stage1.is, params.stage1.n, params.stage1.noClip);
+            chain.getGainStage().setStage2Diode(params.stage2.is, params.stage2.n, params.stage2.noClip);
+        });
+    }
 
-    if (diodeLink) {
-        mGainStage.setStage2Diode(stage1Params.is, stage1Params.n, stage1Params.noClip);
-    } else {
-        auto stage2Params = mDiodeMorpher.getMorphedParams(diodeMorph2);
-        mGainStage.setStage2Diode(stage2Params.is, stage2Params.n, stage2Params.noClip);
+    if (changed & Snapshot::bit(Snapshot::ClipMode))
+        forEachChain([&](auto& chain, int, int) { chain.getGainStage().setClipMode(params.clipMode); });
+    if (changed & Snapshot::bit(Snapshot::ClipAdaa))
+        forEachChain([&](auto& chain, int, int) { chain.getGainStage().setAntialiasing(params.clipAdaa); });
+    if (changed & Snapshot::bit(Snapshot::CircuitModel)) {
+        forEachChain([&](auto& chain, int, int) {
+            using Engine = typename std::decay_t<decltype(chain)>::GainStageType::Engine;
+            chain.getGainStage().setEngine(params.circuitModel ? Engine::Circuit : Engine::Classic);
+        });
     }
 
-    // Update gain stage gain
-    mGainStage.setGain(mSmoothedGain.getNextValue());
+    // Diode solver (Exact for offline-quality bounces, Table for low CPU,
+    // Omega for a fixed per-sample cost); the parameter order matches the enum.
+    // The render profile overrides both while the host renders offline.
+    const bool rendering = isNonRealtime();
+    if ((changed & Snapshot::solverBits) || rendering != mSolverRendering)
+        applySolver(params, rendering);
+
+    // EQ knobs (the tone stack ramps and redesigns on its own)
+    if (changed & Snapshot::eqBits) {
+        forEachChain([&](auto& chain, int, int) {
+            chain.getToneStack().updateCoefficients(params.eqLow, params.eqMid, params.eqMidFreq, params.eqMidQ, params.eqHigh);
+        });
+    }
 
-    // Set clip mode
-    int mode = (clipMode != nullptr) ? (int)std::round(clipMode->load()) : 0;
-    mGainStage.setClipMode(mode);
+    // Oversampling factor / phase (re-prepares the gain stage only on change)
+    if (changed & Snapshot::oversamplingBits) {
+        const int factorLog2 = getOversamplingFactorLog2(params);
+        if (factorLog2 != mOversamplingFactorLog2 || params.osMinPhase != mOversamplingMinPhase)
+            updateOversampling(factorLog2, params.osMinPhase);
+    }
 
-    // Update EQ coefficients (once per block)
-    float eqLow = eqLowParam ? eqLowParam->load() : 0.5f;
-    float eqMid = eqMidParam ? eqMidParam->load() : 0.5f;
-    float eqMidFreq = eqMidFreqParam ? eqMidFreqParam->load() : 0.5f;
-    float eqMidQ = eqMidQParam ? eqMidQParam->load() : 0.3f;
-    float eqHigh = eqHighParam ? eqHighParam->load() : 0.5f;
-    mToneStack.updateCoefficients(eqLow, eqMid, eqMidFreq, eqMidQ, eqHigh);
+    // Saturator position and amount
+    const int satPosition = params.satPosition;  // 0=Pre, 1=Post, 2=Off
+    const float satAmount = params.satAmount;
 
-    // Get buffer info
-    const int numChannels = buffer.getNumChannels();
+    // Channels: every processed channel has its own lane and state. Outputs
+    // beyond the inputs repeat them (e.g. mono in, stereo out); inputs
+    // beyond the outputs are not processed.
     const int numSamples = buffer.getNumSamples();
-
-    // Always use 2 channels (stereo)
-    mBufferDouble.setSize(2, numSamples, false, false, true);
-
-    if (numChannels == 1) {
-        // Mono input: copy to both channels
-        for (int sample = 0; sample < numSamples; ++sample) {
-            double val = static_cast<double>(buffer.getReadPointer(0)[sample]);
-            mBufferDouble.getWritePointer(0)[sample] = val;
-            mBufferDouble.getWritePointer(1)[sample] = val;
-        }
-    } else {
-        // Stereo/multi-channel input
-        for (int ch = 0; ch < juce::jmin(numChannels, 2); ++ch) {
-            std::copy(buffer.getReadPointer(ch),
-                      buffer.getReadPointer(ch) + numSamples,
-                      mBufferDouble.getWritePointer(ch));
+    const int numInputs = std::min(getTotalNumInputChannels(), buffer.getNumChannels());
+    const int numOutputs = std::min(getTotalNumOutputChannels(), buffer.getNumChannels());
+    const int numProcessed = std::min({ mNumChainChannels, numInputs, numOutputs });
+    if (numProcessed == 0)
+        return;
+
+    // --- Sleep mode: skip the whole chain while the input stays silent ---
+    FloatType inputPeak = 0;
+    for (int ch = 0; ch < numInputs; ++ch)
+        inputPeak = std::max(inputPeak, buffer.getMagnitude(ch, 0, numSamples));
+    const bool inputSilent = inputPeak < static_cast<FloatType>(kInputSilence);
+
+    if (mSleeping) {
+        if (inputSilent) {
+            mSmoothedLevel.skip(numSamples);
+            buffer.clear();
+            mAnalyzerFeed.push(buffer.getReadPointer(0), buffer.getReadPointer(0), numSamples);
+            return;
         }
-        // If more than 2 channels, copy extra channels to channel 1
-        for (int ch = 2; ch < numChannels; ++ch) {
-            std::copy(buffer.getReadPointer(ch),
-                      buffer.getReadPointer(ch) + numSamples,
-                      mBufferDouble.getWritePointer(1));
-        }
-    }
-
-    // --- Pre: Apply saturation BEFORE GainStage ---
-    if (satPosition == 0 && satAmount > 0.01f) {
-        applySaturationDouble(mBufferDouble, satAmount);
+        // Wake on this very block: the chain state was cleared on sleeping
+        mSleeping = false;
     }
 
-    // Process DSP (no oversampling for now)
-    for (int sample = 0; sample < numSamples; ++sample) {
-        double level = mSmoothedLevel.getNextValue();
-
-        for (int ch = 0; ch < 2; ++ch) {
-            double x = mBufferDouble.getReadPointer(ch)[sample];
+    // Grow if the host exceeds the prepared block size
+    forEachChain([&](auto& chain, int, int) { chain.ensureBlockSize(numSamples); });
+
+    // Process DSP stage by stage over the whole block
+    mSmoothedLevel.skip(numSamples);
+
+    // Pre saturation BEFORE the gain stage and post saturation AFTER the tone
+    // stack, each fused into the conversion from / to the host buffer
+    const MT2Saturator preSat(satPosition == 0 ? satAmount : 0.0f);
+    const MT2Saturator postSat(satPosition == 1 ? satAmount : 0.0f);
+    FloatType* const* channels = buffer.getArrayOfWritePointers();
+    double outputPeak = 0.0;
+
+    forEachChain([&](auto& chain, int firstChannel, int numChannels) {
+        numChannels = std::min(numChannels, numProcessed - firstChannel);
+        if (numChannels <= 0)
+            return;
+
+        // Dual mono: lanes link after the same hold as sleeping (by then the
+        // state from earlier, different input has decayed below -120 dB)
+        chain.updateLinkedLanes(channels + firstChannel, numChannels, numSamples, mSleepHoldSamples);
+        chain.pack(channels + firstChannel, numChannels, numSamples, preSat);
+        meter.lap(MT2LoadMeter::PreSat);
+
+        // Gain Stage (distortion) at the oversampled rate
+        chain.processGainStage(numSamples);
+        meter.lap(MT2LoadMeter::GainStage);
+
+        // Diode iteration counts of this block (the clippers count regardless)
+        auto& gainStage = chain.getGainStage();
+        if (meter.isActive()) {
+            const auto solverStats = gainStage.getIterationStats();
+            meter.addIterations(solverStats.solves, solverStats.iterations, solverStats.maxIterations);
+        }
+        gainStage.resetIterationStats();
 
-            // Gain Stage (distortion)
-            double gsOut = mGainStage.processSample(x);
+        chain.processToneStack(numSamples);   // Tone Stack (EQ)
+        meter.lap(MT2LoadMeter::ToneStack);
 
-            // Tone Stack (EQ)
-            double eqOut = mToneStack.processSample(gsOut);
+        chain.unpack(channels + firstChannel, numChannels, numSamples, postSat);
+        meter.lap(MT2LoadMeter::PostSat);
 
-            // Store back (will be converted to float)
-            mBufferDouble.getWritePointer(ch)[sample] = eqOut;
-        }
-    }
+        if (inputSilent)
+            outputPeak = std::max(outputPeak, chain.getPeak(numSamples));
+    });
+    // satPosition == 2 (Off): No saturation applied
 
-    // Convert double back to float
-    if (numChannels == 1) {
-        // Mono output: use left channel only
-        for (int sample = 0; sample < numSamples; ++sample) {
-            float val = static_cast<float>(mBufferDouble.getReadPointer(0)[sample]);
-            buffer.getWritePointer(0)[sample] = val;
+    for (int ch = numProcessed; ch < numOutputs; ++ch)
+        buffer.copyFrom(ch, 0, buffer, ch % numProcessed, 0, numSamples);
+    meter.lap(MT2LoadMeter::PostSat);
+
+    // Analyzer: final output, mono sum of the first two channels (decimated
+    // in time, see MT2AnalyzerFeed)
+    mAnalyzerFeed.push(buffer.getReadPointer(0), buffer.getReadPointer(numOutputs > 1 ? 1 : 0), numSamples);
+
+    // Go to sleep once input and output have stayed quiet for the hold time
+    if (inputSilent) {
+        mQuietSamples = outputPeak < kOutputSilence ? mQuietSamples + numSamples : 0;
+        if (mQuietSamples >= mSleepHoldSamples) {
+            // Clear the decayed (possibly denormal) state so waking starts clean
+            forEachChain([](auto& chain, int, int) { chain.reset(); });
+            mSleeping = true;
         }
     } else {
-        // Stereo/multi-channel output
-        for (int ch = 0; ch < juce::jmin(numChannels, 2); ++ch) {
-            for (int sample = 0; sample < numSamples; ++sample) {
-                buffer.getWritePointer(ch)[sample] = static_cast<float>(mBufferDouble.getReadPointer(ch)[sample]);
-            }
-        }
-        // If more than 2 channels, copy channel 1 to extra channels
-        for (int ch = 2; ch < numChannels; ++ch) {
-            for (int sample = 0; sample < numSamples; ++sample) {
-                buffer.getWritePointer(ch)[sample] = buffer.getWritePointer(1)[sample];
-            }
-        }
+        mQuietSamples = 0;
     }
-
-    // --- Post: Apply saturation AFTER ToneStack (to float buffer) ---
-    if (satPosition == 1 && satAmount > 0.01f) {
-        applySaturationFloat(buffer, satAmount);
-    }
-    // satPosition == 2 (Off): No saturation applied
 }
 
 juce::AudioProcessorEditor* MT2Plugin::createEditor()
@@ -1 +1,130 @@
-#pragma once #include <juce\_audio\_processors/juce\_audio\_processors.h> ...
\ No newline at end of file
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "Parameters.h"
+#include "DSP/MT2ChannelChain.h"
+#include "ParameterSnapshot.h"
+#include "LoadMeter.h"
+#include "AnalyzerFeed.h"
+
+class MT2Plugin : public juce::AudioProcessor {
+public:
+    MT2Plugin();
+    ~MT2Plugin() override = default;
+
+    void prepareToPlay(double sampleRate, int maxSamplesPerBlock) override;
+    void releaseResources() override;
+    void reset() override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    /** Any main bus up to kMaxChannels wide. Every channel gets its own DSP
+        state; outputs beyond the inputs repeat them, inputs beyond the
+        outputs are dropped. */
+    static constexpr int kMaxChannels = 32;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override
+    {
+        const int numIn = layouts.getMainInputChannels();
+        const int numOut = layouts.getMainOutputChannels();
+        return numIn > 0 && numIn <= kMaxChannels && numOut > 0 && numOut <= kMaxChannels;
+    }
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override { return true; }
+
+    const juce::String getName() const override { return JucePlugin_Name; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    double getTailLengthSeconds() const override { return mTailSeconds.load(std::memory_order_relaxed); }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    juce::AudioProcessorValueTreeState apvts;
+
+    /** Per-stage timing and diode iteration counts of processBlock.
+        Attach to start metering; it costs nothing while detached. */
+    MT2LoadMeter& getLoadMeter() { return mLoadMeter; }
+
+    /** Output samples for the analyzer; idle while no reader is attached. */
+    MT2AnalyzerFeed& getAnalyzerFeed() { return mAnalyzerFeed; }
+
+private:
+    // Shared by both processBlock overloads; the DSP itself always runs in double
+    template <typename FloatType>
+    void processSamples(juce::AudioBuffer<FloatType>& buffer);
+
+    // DSP: the bus is split into channel groups whose channels run as the
+    // lanes of one SIMD register, each lane with its own state. Four-lane
+    // groups while four or more channels remain, then a stereo pair and a
+    // single channel for the rest (stereo: one pair; 8 channels: two quads).
+    // A mono bus runs one channel once. Groups whose channels carry the
+    // same signal (dual mono) solve the gain stage once for all of them.
+    std::vector<std::unique_ptr<MT2ChannelChain<simd::Double4>>> mQuadChains;
+    std::unique_ptr<MT2ChannelChain<simd::Double2>> mPairChain;
+    std::unique_ptr<MT2ChannelChain<double>> mSingleChain;
+    int mNumChainChannels = 0;
+    void createChains(int numChannels);
+
+    /** f(chain, firstChannel, numChannels) for every group, in channel order */
+    template <typename Function>
+    void forEachChain(Function&& f)
+    {
+        int channel = 0;
+        for (auto& chain : mQuadChains) {
+            f(*chain, channel, 4);
+            channel += 4;
+        }
+        if (mPairChain != nullptr) {
+            f(*mPairChain, channel, 2);
+            channel += 2;
+        }
+        if (mSingleChain != nullptr)
+            f(*mSingleChain, channel, 1);
+    }
+
+    // Oversampling around the gain stage (the tone stack stays at the host rate)
+    void updateOversampling(int factorLog2, bool minimumPhase);
+    int getOversamplingFactorLog2(const MT2ParameterSnapshot::Values& params) const;
+    int mOversamplingFactorLog2 = -1;
+    bool mOversamplingMinPhase = false;
+    void updateTail();
+    double mSampleRate = 44100.0;
+
+    // Render profile (isNonRealtime): no deadline, so oversample at least 4x
+    // with the long filters and solve the diodes exactly. The filters are
+    // chosen in prepareToPlay, the solver every block.
+    static constexpr int kRenderMinOsFactorLog2 = 2;
+    bool mRenderProfile = false;
+    bool mSolverRendering = false;
+    void applySolver(const MT2ParameterSnapshot::Values& params, bool rendering);
+
+    juce::SmoothedValue<double> mSmoothedGain;
+    juce::SmoothedValue<double> mSmoothedLevel;
+
+    // Sleep mode: once the input is silent and the output has decayed for
+    // mSleepHoldSamples, the chain is cleared and skipped until input returns
+    static constexpr double kInputSilence = 1.0e-8;    // below the 24-bit LSB
+    static constexpr double kOutputSilence = 1.0e-6;   // -120 dBFS
+    static constexpr double kTailDecayDb = 120.0;
+    int mQuietSamples = 0;
+    int mSleepHoldSamples = 0;
+    bool mSleeping = false;
+    double mToneStackTailSamples = 0.0;
+    std::atomic<double> mTailSeconds { 0.0 };
+
+    MT2LoadMeter mLoadMeter;
+    MT2AnalyzerFeed mAnalyzerFeed;
+
+    // Parameter values and derived DSP settings, refreshed per block on change only
+    MT2ParameterSnapshot mParameters { apvts };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MT2Plugin)
+};
@@ -0,0 +1,178 @@
+#include "TableCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+    constexpr char kMagic[8] = { 'M', 'T', '2', 'T', 'A', 'B', 'L', 'E' };
+
+    // Native byte order and doubles: a file from another machine fails the
+    // byteOrderCheck and is rebuilt
+    struct Header {
+        char magic[8];
+        juce::uint32 formatVersion;
+        juce::uint32 headerBytes;
+        juce::uint32 numRows;
+        juce::uint32 numNodes;
+        juce::int32 minOctave;
+        juce::uint32 nodesPerOctave;
+        juce::uint32 rowsPerDecade;
+        juce::uint32 numValues;
+        double minLog10K;
+        double byteOrderCheck;
+        juce::uint64 checksum;       // of the values, computed when writing
+    };
+    static_assert(sizeof(Header) == 64 && std::is_trivially_copyable<Header>::value,
+                  "the header keeps the values 8-byte aligned in the mapping");
+
+    // Written after the values: a file cut short or assembled from two
+    // writes has no trailer matching its header
+    struct Trailer {
+        juce::uint64 checksum;       // the header's
+        char magic[8];
+    };
+    static_assert(sizeof(Trailer) == 16 && std::is_trivially_copyable<Trailer>::value, "no padding in the file");
+
+    juce::uint64 checksum(const double* values)
+    {
+        // FNV-1a over the 64-bit patterns
+        juce::uint64 hash = 0xcbf29ce484222325ull;
+        for (int i = 0; i < DiodeTransferTable::NUM_VALUES; ++i) {
+            juce::uint64 bits;
+            std::memcpy(&bits, values + i, sizeof(bits));
+            hash = (hash ^ bits) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    Header makeHeader(juce::uint64 valuesChecksum)
+    {
+        Header h {};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.formatVersion = DiodeTransferTable::FORMAT_VERSION;
+        h.headerBytes = sizeof(Header);
+        h.numRows = DiodeTransferTable::NUM_ROWS;
+        h.numNodes = DiodeTransferTable::NUM_NODES;
+        h.minOctave = DiodeTransferTable::MIN_OCTAVE;
+        h.nodesPerOctave = DiodeTransferTable::NODES_PER_OCTAVE;
+        h.rowsPerDecade = DiodeTransferTable::ROWS_PER_DECADE;
+        h.minLog10K = DiodeTransferTable::MIN_LOG10_K;
+        h.byteOrderCheck = 1.0;
+        h.numValues = DiodeTransferTable::NUM_VALUES;
+        h.checksum = valuesChecksum;
+        return h;
+    }
+
+    Trailer makeTrailer(juce::uint64 valuesChecksum)
+    {
+        Trailer t {};
+        t.checksum = valuesChecksum;
+        std::memcpy(t.magic, kMagic, sizeof(kMagic));
+        return t;
+    }
+
+    constexpr size_t kValueBytes = sizeof(double) * DiodeTransferTable::NUM_VALUES;
+    constexpr size_t kFileBytes = sizeof(Header) + kValueBytes + sizeof(Trailer);
+
+    // A few nodes against the exact solution: catches a table that is
+    // intact but wrong (a solver change without a FORMAT_VERSION bump)
+    bool spotCheck(const double* w)
+    {
+        using T = DiodeTransferTable;
+        for (int row : { 1, T::NUM_ROWS / 2, T::NUM_ROWS - 2 }) {
+            const double k = std::pow(10.0, T::MIN_LOG10_K + static_cast<double>(row) / T::ROWS_PER_DECADE);
+            for (int j : { 0, T::NUM_NODES / 2, T::NUM_NODES - 1 }) {
+                const double expected = T::solveExact(T::nodeU(j), k);
+                if (!(std::abs(w[row * T::NUM_NODES + j] - expected) <= 1e-12 * std::max(1.0, expected)))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<const DiodeTransferTable> mapDiodeTable(const juce::File& file)
+    {
+        if (file.getSize() != static_cast<juce::int64>(kFileBytes))
+            return nullptr;
+
+        auto mapping = std::make_shared<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        if (mapping->getData() == nullptr || mapping->getSize() != kFileBytes)
+            return nullptr;
+
+        // Only the header, the trailer and the spot-checked rows are read
+        // here. Hashing the values would page in the whole file up front;
+        // the rest stays on disk until the clipper first needs it.
+        const auto* bytes = static_cast<const char*>(mapping->getData());
+        const auto* values = reinterpret_cast<const double*>(bytes + sizeof(Header));
+        Header header;
+        std::memcpy(&header, bytes, sizeof(Header));
+        const auto expectedHeader = makeHeader(header.checksum);
+        const auto expectedTrailer = makeTrailer(header.checksum);
+        if (std::memcmp(&header, &expectedHeader, sizeof(Header)) != 0
+            || std::memcmp(bytes + sizeof(Header) + kValueBytes, &expectedTrailer, sizeof(Trailer)) != 0
+            || !spotCheck(values))
+            return nullptr;
+
+        // The table keeps the mapping open for as long as it lives
+        return std::make_shared<const DiodeTransferTable>(values, std::move(mapping));
+    }
+
+    void writeDiodeTable(const juce::File& file, const DiodeTransferTable& table)
+    {
+        if (!file.getParentDirectory().createDirectory())
+            return;
+
+        juce::TemporaryFile temp(file);
+        {
+            juce::FileOutputStream out(temp.getFile());
+            if (!out.openedOk())
+                return;
+
+            const auto valuesChecksum = checksum(table.getData());
+            const auto header = makeHeader(valuesChecksum);
+            const auto trailer = makeTrailer(valuesChecksum);
+            out.write(&header, sizeof(Header));
+            out.write(table.getData(), kValueBytes);
+            out.write(&trailer, sizeof(Trailer));
+            out.flush();
+            if (out.getStatus().failed())
+                return;
+        }
+        temp.overwriteTargetFileWithTemporary();
+    }
+}
+
+std::shared_ptr<const DiodeTransferTable::Future> MT2TableCache::getDiodeTable()
+{
+    // Its own kind: a table built without the cache (DiodeTransferTable::getShared()
+    // from a tool, a gain stage prepared before the plugin) never takes its place
+    return DiodeTransferTable::getSharedAsync("diode-transfer-cache",
+                                              [] { return loadOrBuildDiodeTable(getDiodeTableFile()); });
+}
+
+std::shared_ptr<const DiodeTransferTable> MT2TableCache::loadOrBuildDiodeTable(const juce::File& file)
+{
+    if (auto mapped = mapDiodeTable(file))
+        return mapped;
+
+    auto built = std::make_shared<const DiodeTransferTable>();
+    writeDiodeTable(file, *built);
+    return built;
+}
+
+juce::File MT2TableCache::getDirectory()
+{
+    const auto appData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+#if JUCE_MAC
+    return appData.getChildFile("Caches/K5SANO/MetalCosmos");
+#else
+    return appData.getChildFile("K5SANO/MetalCosmos/Cache");
+#endif
+}
+
+juce::File MT2TableCache::getDiodeTableFile()
+{
+    // The suffix is the file layout (2: with trailer), the version the table's values
+    return getDirectory().getChildFile("DiodeTransferTable-v" + juce::String(DiodeTransferTable::FORMAT_VERSION) + "-2.bin");
+}
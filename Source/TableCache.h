@@ -0,0 +1,37 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "DSP/DiodeTransferTable.h"
+#include <memory>
+
+/** On-disk cache of the precomputed DSP tables.
+
+    Only the diode transfer table is worth caching: it takes tens of
+    milliseconds to solve, every other table (filter kernels, state-space
+    matrices, parameter curves) is built in well under a millisecond.
+
+    - The file is raw doubles between a fixed header, holding the table's
+      FORMAT_VERSION, layout constants and a checksum of the values, and a
+      trailer repeating that checksum. Any mismatch, a wrong size or a
+      failed spot check against the exact solver means it is rebuilt.
+    - A valid file is memory-mapped read-only and the table points straight
+      into the mapping: nothing is copied, every process on the machine
+      shares the same physical pages, and loading reads only the header,
+      the trailer and the spot-checked rows (the values are not hashed).
+    - Writes go to a temporary sibling that atomically replaces the file,
+      so a reader never maps a half-written table.
+    - If the cache directory is not writable the table is simply built
+      every time.
+*/
+class MT2TableCache {
+public:
+    /** The process-wide diode table, loaded or built on a background thread
+        (DiodeTransferTable::getSharedAsync, under its own kind). Returns at once. */
+    static std::shared_ptr<const DiodeTransferTable::Future> getDiodeTable();
+
+    /** Map file if it holds a valid table, else build one and write it there.
+        Blocking; this is what getDiodeTable() runs in the background. */
+    static std::shared_ptr<const DiodeTransferTable> loadOrBuildDiodeTable(const juce::File& file);
+
+    static juce::File getDirectory();
+    static juce::File getDiodeTableFile();
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+/** Latest-value channel from one writer thread to one reader thread.
+
+    Three slots: the writer fills its back slot and swaps it with the middle
+    one; the reader swaps the middle one for its front slot when something
+    new is there. Each side is one atomic exchange, never waits and never
+    retries, and the reader always gets the newest complete value (older
+    unread ones are simply replaced). T should be cheap to copy.
+*/
+template <typename T>
+class TripleBuffer {
+public:
+    /** Writer: publish value (replaces any unread one). */
+    void write(const T& value)
+    {
+        mSlots[static_cast<size_t>(mWriteIndex)] = value;
+        mWriteIndex = mMiddle.exchange(mWriteIndex | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    /** Reader: copies the newest value into out. Returns false (out
+        untouched) if nothing was written since the last read. */
+    bool read(T& out)
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & kFresh) == 0)
+            return false;
+
+        mReadIndex = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel) & kIndexMask;
+        out = mSlots[static_cast<size_t>(mReadIndex)];
+        return true;
+    }
+
+private:
+    static constexpr int kIndexMask = 3;
+    static constexpr int kFresh = 4;
+
+    std::array<T, 3> mSlots {};
+    std::atomic<int> mMiddle { 1 };   // slot index | kFresh
+    int mWriteIndex = 0;              // writer only
+    int mReadIndex = 2;               // reader only
+};
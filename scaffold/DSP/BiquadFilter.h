@@ -1,12 +1,29 @@
 #pragma once
+#include "SimdLanes.h"
 #include <cmath>
 
+/** RBJ biquad (DF-II-T). SampleType is double (one channel) or a simd lane
+    type (several channels sharing the coefficients). */
+template <typename SampleType>
 class BiquadFilter {
 public:
     enum class Type { LowShelf, Peak, HighShelf };
 
+    /** Normalised DF-II-T coefficients (a0 = 1) */
+    struct Coefficients {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+        double a1 = 0.0, a2 = 0.0;
+    };
+
     BiquadFilter() = default;
 
+    static Coefficients makeLowShelf(double freqHz, double gainDb, double q, double sampleRate);
+    static Coefficients makePeak(double freqHz, double gainDb, double q, double sampleRate);
+    static Coefficients makeHighShelf(double freqHz, double gainDb, double q, double sampleRate);
+
+    void setCoefficients(const Coefficients& c);
+    Coefficients getCoefficients() const { return { b0, b1, b2, a1, a2 }; }
+
     /** Compute coefficients for Low Shelf filter */
     void setLowShelf(double freqHz, double gainDb, double q, double sampleRate);
 
@@ -18,7 +35,19 @@ public:
 
     void reset();
 
-    double processSample(double input);
+    /** Samples for the impulse response to fall by decayDb */
+    static double getTailSamples(const Coefficients& c, double decayDb);
+    double getTailSamples(double decayDb) const { return getTailSamples(getCoefficients(), decayDb); }
+
+    SampleType processSample(SampleType input);
+
+    /** Process a block (in == out allowed). */
+    void process(const SampleType* in, SampleType* out, int numSamples);
+
+    /** Process a block while moving the coefficients linearly to target,
+        arriving on the last sample. Keep blocks short (a few tens of
+        samples) so the interpolated filter stays close to the designed one. */
+    void processRamp(const SampleType* in, SampleType* out, int numSamples, const Coefficients& target);
 
 private:
     // Direct Form II Transposed coefficients
@@ -26,5 +55,5 @@ private:
     double a0 = 1.0, a1 = 0.0, a2 = 0.0;
 
     // State
-    double z1 = 0.0, z2 = 0.0;
+    SampleType z1 {}, z2 {};
 };
\ No newline at end of file
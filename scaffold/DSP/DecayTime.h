@@ -0,0 +1,12 @@
+#pragma once
+#include <cmath>
+#include <limits>
+
+/** Samples until an impulse response ringing with the given pole radius has
+    fallen by decayDb. Used to derive tail lengths from filter coefficients. */
+inline double decaySamples(double poleRadius, double decayDb) {
+    poleRadius = std::abs(poleRadius);
+    if (poleRadius <= 0.0) return 1.0;
+    if (poleRadius >= 1.0) return std::numeric_limits<double>::infinity();
+    return std::ceil(-decayDb / (20.0 * std::log10(poleRadius)));
+}
@@ -1,8 +1,46 @@
 #pragma once
+#include "DiodeTransferTable.h"
 #include <cmath>
 
 class DiodeFeedbackClipper {
 public:
+    /** Newton: per-sample Newton-Raphson (exact, for offline bounces).
+        Table: precomputed DiodeTransferTable curve, Newton outside its range.
+        Omega: closed form through the Wright omega function plus one Halley
+        correction; fixed cost per sample (one log, two exp), no table. */
+    enum class Solver { Newton, Table, Omega };
+
+    /** Initial guess for the iteration.
+        Previous: last output. Linear: extrapolated from the last two outputs.
+        Analytic: min(u / (1 + k), asinh(u / k)) in the normalised units of
+        DiodeTransferTable, an upper bound of the solution from which the
+        iteration converges monotonically. Every guess is clamped into
+        [0, that bound] (sign-adjusted). */
+    enum class Predictor { Previous, Linear, Analytic };
+
+    /** Newton, or Halley (uses f'' = k·sinh, which comes for free). Both are
+        safeguarded: the root stays bracketed and a step that leaves the
+        bracket is replaced by bisection. */
+    enum class Step { Newton, Halley };
+
+    /** Convergence tolerance and iteration cap:
+        Eco 1e-5 V / 4, Normal 1e-7 V / 8, High 1e-10 V / 16. */
+    enum class Quality { Eco, Normal, High };
+
+    /** Iteration counts since the last resetIterationStats() */
+    struct IterationStats {
+        int solves = 0;          // samples solved iteratively
+        int iterations = 0;      // total iterations
+        int maxIterations = 0;   // worst sample
+
+        double getAverage() const { return solves > 0 ? static_cast<double>(iterations) / solves : 0.0; }
+        void merge(const IterationStats& other) {
+            solves += other.solves;
+            iterations += other.iterations;
+            maxIterations = other.maxIterations > maxIterations ? other.maxIterations : maxIterations;
+        }
+    };
+
     DiodeFeedbackClipper() = default;
 
     void setDiodeParams(double is, double n);
@@ -10,12 +48,19 @@ public:
     void setSampleRate(double sampleRate);
     void reset();
 
-    /** Process a single sample through the diode feedback clipper.
-        Uses Newton-Raphson iteration to solve the implicit nonlinear equation:
+    /** Process a single sample through the diode feedback clipper, solving
         Vout + Rf * 2 * Is * sinh(Vout / (n * VT)) = Vin * Gain
+        with the selected Solver: the Table curve (the iterative solve
+        outside its range), the Omega closed form, or the safeguarded
+        iteration from the selected Predictor with Newton or Halley Steps
+        up to the Quality's tolerance.
     */
     double processSample(double input);
 
+    /** Process a block (in == out allowed). Solver/bypass branches are taken once per block.
+        stride > 1 walks one lane of an interleaved simd lane buffer. */
+    void process(const double* in, double* out, int numSamples, int stride = 1);
+
     /** When true, bypass diode clipping: Vout = Vin * Gain */
     void setBypass(bool shouldBypass);
 
@@ -25,15 +70,44 @@ public:
     /** Get current gain value */
     double getGain() const { return mGain; }
 
+    /** Select the solver. Table needs a table set via setTransferTable(). */
+    void setSolver(Solver solver);
+
+    /** Shared transfer table (not owned, must outlive the clipper). nullptr = Newton only. */
+    void setTransferTable(const DiodeTransferTable* table);
+
+    void setPredictor(Predictor predictor) { mPredictor = predictor; }
+    void setStep(Step step) { mStep = step; }
+    void setQuality(Quality quality);
+
+    const IterationStats& getIterationStats() const { return mStats; }
+    void resetIterationStats() { mStats = {}; }
+
 private:
+    double processNewton(double target);
+    double processOmega(double target) const;
+    void updateCurve();
+    void updateWarmStart(const double* out, int numSamples, int stride);
+
     double mIs = 2.52e-9;    // Saturation current
     double mN  = 1.7;         // Ideality factor
     double mGain = 100.0;
     double mRf = 1.0;
     double mPrevOutput = 0.0; // Initial guess for Newton-Raphson
+    double mPrevOutput2 = 0.0; // Output before that (linear predictor)
     bool   mBypassed = false;
 
+    Solver mSolver = Solver::Newton;
+    const DiodeTransferTable* mTable = nullptr;
+    DiodeTransferTable::Curve mCurve;   // w(u) for the current Is/n/Rf
+    bool   mCurveValid = false;
+    double mLogHalfK = 0.0;             // ln(k/2) for the omega solver
+
+    Predictor mPredictor = Predictor::Linear;
+    Step      mStep = Step::Halley;
+    double    mTolerance = 1e-7;  // V
+    int       mMaxIter = 8;
+    IterationStats mStats;
+
     static constexpr double VT = 0.02585; // Thermal voltage at ~25°C
-    static constexpr int    MAX_ITER = 8;
-    static constexpr double TOLERANCE = 1e-7;
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include "SharedTables.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Precomputed transfer curves for DiodeFeedbackClipper.
+
+    The clipper equation  Vout + 2·Is·Rf·sinh(Vout / nVT) = Vin·Gain  is
+    normalised with w = Vout/nVT, u = Vin·Gain/nVT and k = 2·Is·Rf/nVT to
+        w + k·sinh(w) = u
+    so one table covers every DiodeMorpher position and both gain stages
+    (Is, n and Rf only enter through k).
+
+    Layout: rows at log10(k) = -9 … -1 in 1/8-decade steps; the outermost row
+    at each end is only a neighbour, so curves exist for -8.875 … -1.125.
+    Each row stores w and dw/du at u = 2^e·(1 + j/32), e = -8 … 16 (32 nodes
+    per octave, odd symmetry, |u| < 2^17). makeCurve() blends the four rows
+    around k with Catmull-Rom weights once per parameter change; per sample
+    the curve is a single cubic Hermite evaluation.
+
+    Error bound vs the converged exact solution (random sweep of 2M points
+    over the whole u/k domain): |Δw| < 3e-5, i.e. |ΔVout| < 1.5 µV for
+    nVT ≤ 0.05 V (about -120 dB re 1 V). The worst case sits at the knee of
+    the curve, where the row blend in log10(k) is least accurate.
+*/
+class DiodeTransferTable {
+public:
+    static constexpr int    NODES_PER_OCTAVE = 32;
+    static constexpr int    MIN_OCTAVE = -8;
+    static constexpr int    MAX_OCTAVE = 17;
+    static constexpr int    NUM_NODES = (MAX_OCTAVE - MIN_OCTAVE) * NODES_PER_OCTAVE + 1;
+    static constexpr int    ROWS_PER_DECADE = 8;
+    static constexpr double MIN_LOG10_K = -9.0;
+    static constexpr double MAX_LOG10_K = -1.0;
+    static constexpr int    NUM_ROWS = static_cast<int>((MAX_LOG10_K - MIN_LOG10_K) * ROWS_PER_DECADE) + 1;
+
+    /** getData() layout: all w rows, then all dw/du rows */
+    static constexpr int    NUM_VALUES = 2 * NUM_ROWS * NUM_NODES;
+
+    /** Bump whenever the layout or the values change (cache files key on it) */
+    static constexpr int    FORMAT_VERSION = 1;
+
+    using Future = SharedTables::Future<DiodeTransferTable>;
+
+    /** One transfer curve w(u) for a fixed k. */
+    struct Curve {
+        std::array<double, NUM_NODES> w {};
+        std::array<double, NUM_NODES> dw {};   // dw/du
+        double k = 0.0;
+
+        /** Returns w for |u| < 2^MAX_OCTAVE, or NaN when u is outside the table. */
+        double eval(double u) const;
+    };
+
+    /** Builds all rows (tens of milliseconds; do not call on the audio thread). */
+    DiodeTransferTable();
+
+    /** Uses NUM_VALUES precomputed values in getData() layout without
+        copying them, e.g. straight from a memory-mapped cache file.
+        keepAlive owns that memory for the lifetime of the table. */
+    DiodeTransferTable(const double* data, std::shared_ptr<const void> keepAlive);
+
+    DiodeTransferTable(const DiodeTransferTable&) = delete;
+    DiodeTransferTable& operator=(const DiodeTransferTable&) = delete;
+
+    /** The process-wide table (SharedTables), built in the background by
+        the constructor above and shared by every later caller. Returns at
+        once; not real-time safe. */
+    static std::shared_ptr<const Future> getSharedAsync();
+
+    /** A process-wide table from another source (e.g. a cache file), made by
+        build and shared under its own kind: it never stands in for the
+        built table or the other way round, whichever is asked for first. */
+    static std::shared_ptr<const Future> getSharedAsync(const std::string& kind, Future::Build build);
+
+    /** As getSharedAsync(), waiting for the build. */
+    static std::shared_ptr<const DiodeTransferTable> getShared();
+
+    /** NUM_VALUES values, for writing a cache file */
+    const double* getData() const { return mW; }
+
+    /** Blend the rows around k into curve. Returns false when k is outside the table. */
+    bool makeCurve(double k, Curve& curve) const;
+
+    /** Converged solution of w + k·sinh(w) = u (monotone Newton, used to build the table). */
+    static double solveExact(double u, double k);
+
+    /** Closed-form solution of w + k·sinh(w) = u at fixed cost: Wright omega
+        for the dominant exponential, then one Halley step on the full
+        equation. logHalfK = ln(k/2), precomputed by the caller.
+        |Δw| < 2e-6 over the table's k range. */
+    static double solveOmega(double u, double k, double logHalfK);
+
+    /** u at node index j (j = 0 … NUM_NODES-1). */
+    static double nodeU(int j);
+
+private:
+    std::vector<double> mStorage;             // empty when the data is external
+    std::shared_ptr<const void> mKeepAlive;   // owner of external data
+    const double* mW = nullptr;               // NUM_ROWS × NUM_NODES
+    const double* mDw = nullptr;
+};
@@ -0,0 +1,324 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/** Branch-free approximations of the transcendental functions used in the
+    hot loops, for float and double.
+
+    Every function is straight-line arithmetic (range reduction by the
+    round-to-nearest shifter trick, then a fixed polynomial or rational
+    kernel), so a loop over contiguous samples auto-vectorises: two doubles
+    or four floats per SSE2 / NEON instruction, more with AVX. Polynomials
+    use Estrin's scheme, which also keeps scalar latency down (the diode
+    Newton loop is serial).
+
+    Maximum error against libm over the stated domain (measured with
+    MetalCosmosBench --accuracy, libm evaluated in double; ulp = unit in the
+    last place):
+
+        function   domain                 double          float
+        exp        |x| ≤ 700 (86 float)   3 ulp           2 ulp
+        log        normal x > 0           2 ulp           2 ulp
+        tanh       all x                  3.4e-16 abs     1.8e-7 abs
+        atan       finite x               1 ulp           3 ulp
+        sinhcosh   |x| ≤ 700 (86 float)   5 ulp           4 ulp
+        sin        |x| ≤ 1e5 (1e3 float)  3.4e-16 abs     1.8e-7 abs
+        omega      all x                  7e-5 abs (an initial guess plus one Newton step)
+
+    The float tanh and sin bounds also hold against tanhf and sinf, whose
+    own rounding adds to the difference; against double they are 1.0e-7
+    and 1.5e-7.
+
+    exp and sinhcosh saturate outside their domain instead of overflowing.
+*/
+namespace fastmath {
+
+namespace detail {
+    template <typename T> struct Traits;
+
+    template <> struct Traits<double> {
+        using Bits = std::uint64_t;
+        static constexpr int mantissaBits = 52;
+        static constexpr double shifter = 6755399441055744.0;   // 1.5·2^52: adding it rounds to an integer
+        static constexpr double expLimit = 700.0;
+
+        // ln 2 split so that k·ln2Hi is exact
+        static constexpr double ln2Hi = 6.93147180369123816490e-01;
+        static constexpr double ln2Lo = 1.90821492927058770002e-10;
+
+        // π split so that k·piA is exact (Cody-Waite)
+        static constexpr double piA = 3.14159262180328369140625;
+        static constexpr double piB = 3.178650942459171346856e-8;
+        static constexpr double piC = 1.224646799147353177228e-16;
+
+        static constexpr int expDegree = 12;    // Taylor on |r| ≤ ln2/2
+        static constexpr int sinhDegree = 8;    // odd terms x^3 … x^17 on |x| ≤ 1
+        static constexpr int sinDegree = 10;    // odd terms r^3 … r^21 on |r| ≤ π/2
+        static constexpr int logDegree = 10;    // s^2 … s^20 on |s| ≤ 0.172
+    };
+
+    template <> struct Traits<float> {
+        using Bits = std::uint32_t;
+        static constexpr int mantissaBits = 23;
+        static constexpr float shifter = 12582912.0f;            // 1.5·2^23
+        static constexpr float expLimit = 86.0f;
+
+        static constexpr float ln2Hi = 6.9314575195e-01f;
+        static constexpr float ln2Lo = 1.4286067653e-06f;
+
+        static constexpr float piA = 3.140625f;
+        static constexpr float piB = 9.67502593994140625e-4f;
+        static constexpr float piC = 1.509957990978376432e-7f;
+
+        static constexpr int expDegree = 7;
+        static constexpr int sinhDegree = 4;    // x^3 … x^9
+        static constexpr int sinDegree = 6;     // r^3 … r^13
+        static constexpr int logDegree = 5;     // s^2 … s^10
+    };
+
+    template <typename T>
+    inline typename Traits<T>::Bits toBits(T x) {
+        typename Traits<T>::Bits b;
+        std::memcpy(&b, &x, sizeof x);
+        return b;
+    }
+
+    template <typename T>
+    inline T fromBits(typename Traits<T>::Bits b) {
+        T x;
+        std::memcpy(&x, &b, sizeof x);
+        return x;
+    }
+
+    // Coefficients 1/k! (exp), (±)1/(2k+1)! (sinh, sin) and 1/(2k+1) (log),
+    // built at compile time
+    template <typename T, int N>
+    struct Series {
+        T exp[N + 1] {};
+        T sinh[N + 1] {};
+        T sin[N + 1] {};
+        T log[N + 1] {};
+
+        constexpr Series() {
+            for (int k = 0; k <= N; ++k)
+                log[k] = static_cast<T>(1.0 / (2.0 * k + 1.0));
+            double factorial = 1.0;
+            for (int k = 0; k <= N; ++k) {
+                if (k > 0) factorial *= k;
+                exp[k] = static_cast<T>(1.0 / factorial);
+            }
+            factorial = 1.0;
+            for (int k = 0; k <= N; ++k) {
+                if (k > 0) factorial *= (2.0 * k) * (2.0 * k + 1.0);
+                sinh[k] = static_cast<T>(1.0 / factorial);
+                sin[k] = static_cast<T>((k % 2 == 0 ? 1.0 : -1.0) / factorial);
+            }
+        }
+    };
+
+    template <typename T>
+    inline constexpr Series<T, 12> series {};
+
+    // 1 where v ≥ edge, else 0, without a compare. Compare-based selects get
+    // turned back into branches by GCC, which stops loops from vectorising;
+    // blending with w·a + (1 - w)·b is exact for finite a and b.
+    template <typename T>
+    inline T step(T v, T edge) {
+        return static_cast<T>(0.5) + std::copysign(static_cast<T>(0.5), v - edge);
+    }
+
+    // x^n by squaring, unrolled at compile time
+    template <int n, typename T>
+    inline T power(T x) {
+        if constexpr (n == 1) return x;
+        else if constexpr (n % 2 == 0) return power<n / 2>(x * x);
+        else return x * power<n - 1>(x);
+    }
+
+    // c[0] + c[1]·x + … + c[n-1]·x^(n-1) by Estrin's scheme: split into
+    // low + x^m·high halves recursively, so the dependency chain is about
+    // log2(n) multiply-adds long instead of n (Horner)
+    template <int n, typename T>
+    inline T estrin(const T* c, T x) {
+        if constexpr (n == 1) {
+            return c[0];
+        } else {
+            constexpr int m = (n + 1) / 2;
+            return estrin<m>(c, x) + power<m>(x) * estrin<n - m>(c + m, x);
+        }
+    }
+
+    // c[0] + c[1]·x + … + c[degree]·x^degree
+    template <int degree, typename T>
+    inline T polynomial(const T* c, T x) {
+        return estrin<degree + 1>(c, x);
+    }
+}
+
+/** e^x */
+template <typename T>
+inline T exp(T x) {
+    using Tr = detail::Traits<T>;
+    using Bits = typename Tr::Bits;
+
+    // One select on |x|: a two-sided clamp gets split into branches by GCC
+    const T ax = std::abs(x);
+    x = std::copysign(ax < Tr::expLimit ? ax : Tr::expLimit, x);
+
+    // x = k·ln2 + r with k integral and |r| ≤ ln2/2
+    const T shifted = x * static_cast<T>(1.4426950408889634) + Tr::shifter;
+    const T k = shifted - Tr::shifter;
+    const T r = (x - k * Tr::ln2Hi) - k * Tr::ln2Lo;
+
+    const T p = detail::polynomial<Tr::expDegree>(detail::series<T>.exp, r);
+
+    // Scale by 2^k by adding k to the exponent field
+    const Bits kBits = detail::toBits(shifted) - detail::toBits(Tr::shifter);
+    return detail::fromBits<T>(detail::toBits(p) + (kBits << Tr::mantissaBits));
+}
+
+/** ln(x) for finite x > 0 (normal numbers): x = m·2^e with m in [√½, √2),
+    ln(m) = 2·atanh(s) with s = (m - 1) / (m + 1), odd series in s */
+template <typename T>
+inline T log(T x) {
+    using Tr = detail::Traits<T>;
+    using Bits = typename Tr::Bits;
+    constexpr Bits exponentMask = (Bits { 1 } << (8 * sizeof(T) - 1)) - (Bits { 1 } << Tr::mantissaBits);
+    constexpr Bits oneBits = Bits { (1 << (8 * sizeof(T) - Tr::mantissaBits - 2)) - 1 } << Tr::mantissaBits;
+    const T one = static_cast<T>(1);
+
+    // Mantissa in [1, 2) and unbiased exponent
+    const Bits bits = detail::toBits(x);
+    T m = detail::fromBits<T>((bits & ~exponentMask) | oneBits);
+    T e = static_cast<T>(static_cast<int>(bits >> Tr::mantissaBits) - static_cast<int>(oneBits >> Tr::mantissaBits));
+
+    // Fold [√2, 2) down to [√½, 1)
+    const T upper = detail::step(m, static_cast<T>(1.4142135623730951));
+    m *= one - static_cast<T>(0.5) * upper;
+    e += upper;
+
+    const T s = (m - one) / (m + one);
+    const T z = s * s;
+    const T logM = static_cast<T>(2) * (s + s * z * detail::polynomial<Tr::logDegree - 1>(detail::series<T>.log + 1, z));
+    return e * Tr::ln2Hi + (logM + e * Tr::ln2Lo);
+}
+
+/** Wright omega ω(x), the solution y of y + ln(y) = x (ω(x) = W0(e^x)).
+    Piecewise initial guess in the spirit of D'Angelo, Gabrielli & Turchet,
+    "Fast approximation of the Lambert W function for virtual analog
+    modelling" (DAFx 2019): 0 below x = -6, a quintic fitted at Chebyshev
+    nodes up to x = 8, x - L + L/x (L = ln x) above; then one Newton step on
+    y - e^(x - y). Fixed cost of one log and one exp; absolute error below
+    7e-5 (relative 5e-4) for all x. */
+template <typename T>
+inline T omega(T x) {
+    using detail::step;
+    const T one = static_cast<T>(1);
+    static constexpr T quintic[] = {
+        static_cast<T>(5.813720336871550e-01), static_cast<T>(3.716132970721552e-01),
+        static_cast<T>(6.343716362906324e-02), static_cast<T>(-1.070963507749316e-03),
+        static_cast<T>(-4.848800969397205e-04), static_cast<T>(3.363122153181885e-05),
+    };
+
+    const T high = step(x, static_cast<T>(8));
+    const T middle = step(x, static_cast<T>(-6)) - high;
+    const T xHigh = high * x + (one - high);   // 1 below 8, so L = 0 there
+    const T L = fastmath::log(xHigh);
+
+    const T y = middle * detail::polynomial<5>(quintic, x) + high * (x - L + L / xHigh);
+    const T e = fastmath::exp(x - y);
+    return y - (y - e) / (one + e);
+}
+
+/** tanh(x) = (1 - e^-2|x|) / (1 + e^-2|x|), sign restored */
+template <typename T>
+inline T tanh(T x) {
+    const T e = fastmath::exp(static_cast<T>(-2) * std::abs(x));
+    return std::copysign((static_cast<T>(1) - e) / (static_cast<T>(1) + e), x);
+}
+
+/** sinh(x) and cosh(x) from one exp; sinh uses its series up to |x| = 1
+    where the difference of exponentials would cancel. */
+template <typename T>
+inline void sinhcosh(T x, T& sinhOut, T& coshOut) {
+    using Tr = detail::Traits<T>;
+
+    const T e = fastmath::exp(x);
+    const T eInv = static_cast<T>(1) / e;
+    coshOut = static_cast<T>(0.5) * (e + eInv);
+
+    const T x2 = x * x;
+    const T series = x + x * x2 * detail::polynomial<Tr::sinhDegree - 1>(detail::series<T>.sinh + 1, x2);
+    const T fromExp = static_cast<T>(0.5) * (e - eInv);
+    const T useSeries = detail::step(static_cast<T>(1), std::abs(x));
+    sinhOut = useSeries * series + (static_cast<T>(1) - useSeries) * fromExp;
+}
+
+/** atan(x): reduced to |r| ≤ 0.66 (double) / tan(π/8) (float) around 0, π/4
+    or π/2, then a rational (double) or polynomial (float) kernel after Cephes.
+    The three reductions are blended with 0/1 steps (big implies mid):
+        none: a / 1        mid: (a - 1) / (a + 1) + π/4        big: -1 / a + π/2 */
+template <typename T>
+inline T atan(T x) {
+    const T a = std::abs(x);
+    const T one = static_cast<T>(1);
+    using detail::step;
+
+    if constexpr (std::is_same_v<T, double>) {
+        constexpr double moreBits = 6.123233995736765886130e-17;   // π/2 - double(π/2)
+        const double big = step(a, 2.414213562373095);              // tan(3π/8)
+        const double mid = step(a, 0.66);
+
+        const double r = (a - mid - big * a) / (one + mid * a - big);
+        const double base = (mid + big) * 0.7853981633974483;
+        const double extra = (mid + big) * (0.5 * moreBits);
+
+        const double z = r * r;
+        const double p = (((( -8.750608600031904122785e-1 * z
+                              - 1.615753718733365076637e1) * z
+                              - 7.500855792314704667340e1) * z
+                              - 1.228866684490136173410e2) * z
+                              - 6.485021904942025371773e1) * z;
+        const double q = ((((z + 2.485846490142306297962e1) * z
+                               + 1.650270098316988542046e2) * z
+                               + 4.328810604912902668951e2) * z
+                               + 4.853903996359136964868e2) * z
+                               + 1.945506571482613964425e2;
+
+        return std::copysign(base + (r * (p / q) + r + extra), x);
+    } else {
+        const float big = step(a, 2.414213562373095f);
+        const float mid = step(a, 0.4142135623730950f);             // tan(π/8)
+
+        const float r = (a - mid - big * a) / (one + mid * a - big);
+        const float base = (mid + big) * 0.7853981633974483f;
+
+        const float z = r * r;
+        const float p = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z
+                          + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z;
+
+        return std::copysign(base + (r * p + r), x);
+    }
+}
+
+/** sin(x): x = k·π + r with |r| ≤ π/2, odd series in r, sign flipped for odd k */
+template <typename T>
+inline T sin(T x) {
+    using Tr = detail::Traits<T>;
+    using Bits = typename Tr::Bits;
+
+    const T shifted = x * static_cast<T>(0.31830988618379067) + Tr::shifter;
+    const T k = shifted - Tr::shifter;
+    const T r = ((x - k * Tr::piA) - k * Tr::piB) - k * Tr::piC;
+
+    const T r2 = r * r;
+    const T s = r + r * r2 * detail::polynomial<Tr::sinDegree - 1>(detail::series<T>.sin + 1, r2);
+
+    // (-1)^k: the low bit of k goes to the sign bit
+    const Bits kBits = detail::toBits(shifted) - detail::toBits(Tr::shifter);
+    return detail::fromBits<T>(detail::toBits(s) ^ (kBits << (8 * sizeof(T) - 1)));
+}
+
+} // namespace fastmath
@@ -0,0 +1,76 @@
+#pragma once
+#include "MT2ChannelChain.h"
+#include "MetalCosmosDsp.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+/** Many independent mono streams through the MetalCosmos chain, for
+    rendering in bulk outside a plugin host (behind the C interface in
+    MetalCosmosDsp.h).
+
+    Lanes of one MT2ChannelChain share their settings, so start() sorts the
+    streams by parameters and packs each set of equal streams into groups
+    the way the plugin packs a bus: four lanes (simd::Double4) while four
+    or more remain, then two, then one. Every state variable of a group
+    holds its streams side by side (structure of arrays), so one
+    instruction advances all of them; a stream with settings of its own
+    runs in a one-lane group.
+
+    Not thread-safe: one engine per thread. The heavy tables are shared
+    process-wide (SharedTables), so extra engines cost little. */
+class MT2BatchEngine {
+public:
+    /** Not real-time safe (allocates, loads the shared tables). */
+    explicit MT2BatchEngine(const MT2BatchConfig& config);
+
+    int getNumStreams() const { return static_cast<int>(mParams.size()); }
+
+    /** Takes effect at the next start(). */
+    void setStreamParams(int stream, const MT2StreamParams& params);
+    const MT2StreamParams& getStreamParams(int stream) const { return mParams[static_cast<size_t>(stream)]; }
+
+    /** Groups the streams and starts all of them from silence. Allocates. */
+    void start();
+    bool isStarted() const { return mStarted; }
+
+    /** One pointer per stream (in == out allowed), any numSamples. Does not allocate. */
+    template <typename FloatType>
+    void process(const FloatType* const* inputs, FloatType* const* outputs, int numSamples);
+
+    int getLatencySamples() const { return mLatencySamples; }
+
+    /** Groups after start() (one per lane width and parameter set) */
+    int getNumGroups() const { return static_cast<int>(mQuads.size() + mPairs.size() + mSingles.size()); }
+
+private:
+    template <typename SampleType>
+    struct Group {
+        static constexpr int numLanes = simd::Lanes<SampleType>::count;
+
+        MT2ChannelChain<SampleType> chain;
+        std::array<int, numLanes> streams {};
+        MT2Saturator preSat { 0.0f };
+        MT2Saturator postSat { 0.0f };
+    };
+
+    template <typename SampleType>
+    void addGroup(std::vector<std::unique_ptr<Group<SampleType>>>& groups, const int* streams);
+
+    template <typename SampleType>
+    void configure(Group<SampleType>& group, const MT2StreamParams& params);
+
+    template <typename FloatType, typename SampleType>
+    static void processGroup(Group<SampleType>& group, const FloatType* const* inputs, FloatType* const* outputs,
+                             int offset, int numSamples);
+
+    MT2BatchConfig mConfig;
+    std::vector<MT2StreamParams> mParams;
+    std::shared_ptr<const DiodeTransferTable> mDiodeTable;
+
+    std::vector<std::unique_ptr<Group<simd::Double4>>> mQuads;
+    std::vector<std::unique_ptr<Group<simd::Double2>>> mPairs;
+    std::vector<std::unique_ptr<Group<double>>> mSingles;
+    int mLatencySamples = 0;
+    bool mStarted = false;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include "FastMath.h"
+#include "MT2GainStage.h"
+#include "MT2ToneStack.h"
+#include "Oversampler.h"
+#include "SimdLanes.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/** Output saturator: tanh(x·drive) / tanh(drive), drive = 1 + 3·amount */
+struct MT2Saturator {
+    explicit MT2Saturator(float amount)
+        : active(amount >= 0.01f),
+          drive(1.0 + static_cast<double>(amount) * 3.0),
+          norm(1.0 / std::tanh(drive)) {}
+
+    double operator()(double x) const { return fastmath::tanh(x * drive) * norm; }
+
+    bool active;
+    double drive;
+    double norm;
+};
+
+/** One group of channels through the whole MetalCosmos chain:
+    pre saturation → gain stage (oversampled) → tone stack → post saturation.
+
+    SampleType sets the group width: double runs one channel, simd::Double2
+    two and simd::Double4 four, each channel in its own lane with its own
+    state. The plugin splits a bus of any width into groups. The stages are
+    separate calls so the caller can time each one; parameters are set on
+    the modules directly (getGainStage() …). */
+template <typename SampleType>
+class MT2ChannelChain {
+public:
+    static constexpr int numLanes = simd::Lanes<SampleType>::count;
+    using GainStageType = MT2GainStage<SampleType>;
+    using OversamplerType = Oversampler<SampleType>;
+
+    /** Allocates for maxBlockSize and loads the gain stage's tables for every
+        oversampling factor. Not real-time safe. */
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    /** Grows the buffers when a host exceeds the prepared block size (allocates). */
+    void ensureBlockSize(int numSamples);
+
+    /** Re-prepares the gain stage at the new rate; real-time safe after prepare(). */
+    void setOversampling(int factorLog2, bool minimumPhase);
+
+    /** Oversampler Live / Render designs (Oversampler::Quality). Not real-time safe. */
+    void setOversamplingQuality(bool render);
+
+    /** Host channels → lanes, with the pre saturator fused into the same
+        pass. numChannels ≤ numLanes; lanes without a channel get silence. */
+    template <typename FloatType>
+    void pack(const FloatType* const* channels, int numChannels, int numSamples, const MT2Saturator& sat);
+
+    /** Dual-mono fast path, called once per block before pack(). While all
+        numLanes channels carry the same samples, the gain stage solves one
+        lane for all of them (MT2GainStage::setLinkedLanes). Lanes only link
+        once their inputs have matched for holdSamples (the gain stage's
+        tail at the host rate plus a margin: the diodes slow the decay), so
+        state left from different content has died away; the first block
+        that differs unlinks before it runs. */
+    template <typename FloatType>
+    void updateLinkedLanes(const FloatType* const* channels, int numChannels, int numSamples, int holdSamples);
+
+    void processGainStage(int numSamples);
+    void processToneStack(int numSamples);
+
+    /** Lanes → host channels, with the post saturator fused into the same pass */
+    template <typename FloatType>
+    void unpack(FloatType* const* channels, int numChannels, int numSamples, const MT2Saturator& sat) const;
+
+    /** Largest magnitude in the lanes after the tone stack (before post saturation) */
+    double getPeak(int numSamples) const;
+
+    GainStageType& getGainStage() { return mGainStage; }
+    const GainStageType& getGainStage() const { return mGainStage; }
+    MT2ToneStack<SampleType>& getToneStack() { return mToneStack; }
+    const MT2ToneStack<SampleType>& getToneStack() const { return mToneStack; }
+    OversamplerType& getOversampler() { return mOversampler; }
+    const OversamplerType& getOversampler() const { return mOversampler; }
+
+private:
+    GainStageType mGainStage;
+    MT2ToneStack<SampleType> mToneStack;
+    OversamplerType mOversampler;
+
+    std::vector<SampleType> mLanes;   // one block at the host rate
+
+    // Host samples since the lanes' inputs last differed (at rest they are the same)
+    static constexpr int kLanesAtRest = std::numeric_limits<int>::max();
+    int mSameSamples = kLanesAtRest;
+    double mSampleRate = 44100.0;
+    int mMaxBlockSize = 0;
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include "DiodeTransferTable.h"
+#include "SimdLanes.h"
+#include <array>
+#include <memory>
+
+/** MT-2 gain stage as one circuit, discretised with the DK method (nodal
+    analysis with trapezoidal capacitor companions; Yeh, Abel & Smith 2010,
+    Holters & Zölzer 2011). Alternative to the clipper → one-pole → clipper
+    chain of MT2GainStage: the interstage network loads both op-amp stages
+    and the feedback capacitors band-limit the clipping, as in the pedal.
+
+    Netlist (ideal op-amps, non-inverting inputs grounded):
+
+        in ─ Ri ─ inv1 ─┬─ Rf1 ─┬─ out1 ─ Rl ─ n1 ─ Cc ─ n2 ─ R2 ─ inv2 ─┬─ Rf2 ─┬─ out2
+                        ├─ Cf1 ─┤              │                         ├─ Cf2 ─┤
+                        └─ D1  ─┘              Cl                        └─ D2  ─┘
+                                               ⊥
+
+        Ri = Rf1 = 10k (the drive enters as u = gain·in), Cf1 = 100p
+        Rl = 330, Cl = 190n, Cc = 680n, R2 = 845     (≈ 3.5 kHz / 200 Hz)
+        Rf2 = 4k7, Cf2 = 220p                         (stage 2 gain 4)
+        D1, D2 = antiparallel pairs, i = 2·Is·sinh(v / nVT)
+
+    The linear network is solved once per sample rate (MT2CircuitStateSpace) into
+        x[n] = A·x[n-1] + B·u[n] + C·i[n]      4 capacitor states
+        v[n] = D·x[n-1] + E·u[n] + K·i[n]      2 diode ports
+        y[n] = G·x[n-1] + H·u[n] + L·i[n]      output (out2)
+    K is lower triangular (an ideal op-amp output is a voltage source, so
+    stage 2 cannot load stage 1), so the port equations v = p + K·i(v) are
+    solved one after the other. Each is w + k·sinh(w) = u with k = 2·Is·|Kjj|/nVT,
+    read from a DiodeTransferTable curve blended once per diode change: no
+    iteration, two Hermite lookups and about 50 multiply-adds per sample and
+    lane. Where the table does not reach, DiodeTransferTable::solveOmega
+    (also fixed cost) takes over.
+
+    NoClip removes that stage's diodes; to keep the unity-gain meaning it has
+    in MT2GainStage, stage 1 then drops the drive gain and stage 2 scales its
+    output by 1/4.
+*/
+/** The discretised linear network of MT2CircuitModel at one sample rate.
+    Immutable once built and shared by every model at that rate (SharedTables). */
+struct MT2CircuitStateSpace {
+    static constexpr int NUM_STATES = 4;
+    static constexpr int NUM_PORTS = 2;
+    using Row = std::array<double, NUM_STATES>;
+
+    std::array<Row, NUM_STATES> A {};
+    std::array<double, NUM_STATES> B {};
+    std::array<std::array<double, NUM_PORTS>, NUM_STATES> C {};
+    std::array<Row, NUM_PORTS> D {};
+    std::array<double, NUM_PORTS> E {};
+    std::array<std::array<double, NUM_PORTS>, NUM_PORTS> K {};
+    Row G {};
+    double H = 0.0;
+    std::array<double, NUM_PORTS> L {};
+    double spectralRadius = 0.0;   // of A, for the tail length
+    double sampleRate = 0.0;
+
+    /** Solves the network (not real-time safe). */
+    explicit MT2CircuitStateSpace(double sampleRate);
+
+    /** The process-wide copy for this rate. Not real-time safe. */
+    static std::shared_ptr<const MT2CircuitStateSpace> getShared(double sampleRate);
+};
+
+template <typename SampleType>
+class MT2CircuitModel {
+public:
+    static constexpr int numLanes = simd::Lanes<SampleType>::count;
+    static constexpr int NUM_STATES = MT2CircuitStateSpace::NUM_STATES;
+    static constexpr int NUM_PORTS = MT2CircuitStateSpace::NUM_PORTS;
+
+    /** Takes the state-space matrices for this sample rate (shared). Not
+        real-time safe unless the rate was preloaded. */
+    void prepare(double sampleRate);
+
+    /** Fetch the matrices for a rate prepare() may be called with later (the
+        last MAX_PRELOADED are kept), so that prepare() does not touch the
+        registry. Not real-time safe. */
+    void preload(double sampleRate);
+    static constexpr int MAX_PRELOADED = 4;
+    void reset();
+
+    /** Samples for the linear network's impulse response to fall by decayDb */
+    double getTailSamples(double decayDb) const;
+
+    /** Stage 1 closed-loop gain Rf1/Ri (the dist control) */
+    void setGain(double gain) { mGain = gain; }
+    void setStage1Diode(double is, double n, bool noClip) { setDiode(0, is, n, noClip); }
+    void setStage2Diode(double is, double n, bool noClip) { setDiode(1, is, n, noClip); }
+
+    /** Shared transfer table (not owned, must outlive the model). nullptr = closed form only. */
+    void setDiodeTable(const DiodeTransferTable* table);
+
+    /** Process a block (in == out allowed). */
+    void process(const SampleType* in, SampleType* out, int numSamples);
+
+    /** Every lane carries the same signal: only lane 0 is solved and the
+        others repeat it. Unlinking hands lane 0's state to the others. */
+    void setLinkedLanes(bool linked);
+
+private:
+    struct Port {
+        double is = 2.52e-9;
+        double n = 1.7;
+        bool noClip = false;
+        double nVT = 0.0;
+        double invNVT = 0.0;
+        double k = 0.0;          // 2·Is·|Kjj| / nVT
+        double logHalfK = 0.0;
+        DiodeTransferTable::Curve curve;
+        bool curveValid = false;
+    };
+
+    void setDiode(int port, double is, double n, bool noClip);
+    void updatePort(int port);
+
+    /** Port voltage for v = p + K·i(v), K = mK[port][port] < 0 */
+    double solvePort(const Port& port, double p) const;
+
+    std::shared_ptr<const MT2CircuitStateSpace> mStateSpace;
+    std::array<std::shared_ptr<const MT2CircuitStateSpace>, MAX_PRELOADED> mPreloaded;   // newest first
+
+    std::array<Port, NUM_PORTS> mPorts;
+    const DiodeTransferTable* mTable = nullptr;
+    double mGain = 1.0;
+
+    std::array<std::array<double, NUM_STATES>, numLanes> mX {};   // per lane
+    bool mLinked = false;
+
+    static constexpr double VT = 0.02585;
+};
@@ -1,29 +1,124 @@
 #pragma once
 #include "DiodeFeedbackClipper.h"
+#include "MT2CircuitModel.h"
 #include "OnePoleFilter.h"
+#include "SimdLanes.h"
+#include <array>
 #include <cmath>
+#include <memory>
 
+/** MT-2 gain stage: clipper → 200 Hz HPF → 3.5 kHz LPF → clipper.
+    SampleType is double (one channel) or a simd lane type: every lane is an
+    independent channel with its own clipper and filter state, and the
+    interstage filters run all lanes in one register. */
+template <typename SampleType>
 class MT2GainStage {
 public:
+    static constexpr int numLanes = simd::Lanes<SampleType>::count;
+
+    /** Classic: clipper → one-pole filters → clipper (below).
+        Circuit: the whole stage as a DK-method state-space model
+        (MT2CircuitModel). Circuit applies to the Diode clip mode only; the
+        static clip modes always use the classic chain. */
+    enum class Engine { Classic, Circuit };
+
     MT2GainStage();
 
     void prepare(double sampleRate);
     void reset();
 
+    /** Fetch the shared tables for a rate prepare() may later be called with
+        on the audio thread (e.g. every oversampling factor). Not real-time safe. */
+    void preload(double sampleRate) { mCircuit.preload(sampleRate); }
+
+    /** Samples (at the prepared rate) for the interstage filters' impulse
+        response to fall by decayDb (the longer of the two engines). The
+        clippers themselves hold no state. */
+    double getTailSamples(double decayDb) const;
+
     void setGain(double gain);
+
+    /** The dist knob (0 … 1) as stage 1 gain: 5.6 … 200, exponential */
+    static double gainForDist(float dist) { return 5.6 * std::pow(200.0 / 5.6, dist); }
     void setStage1Diode(double is, double n, bool noClip);
     void setStage2Diode(double is, double n, bool noClip);
     void setClipMode(int mode);
 
-    double processSample(double input);
+    /** Real-time safe; both engines are always prepared. Switching resets the new engine. */
+    void setEngine(Engine engine);
+
+    /** First-order antiderivative anti-aliasing for the static clip modes
+        (1-5). Adds half a sample of delay per clip stage; Diode mode is
+        unaffected. */
+    void setAntialiasing(bool enabled);
+
+    /** Diode solver for both stages (Newton = exact, Table = precomputed curves,
+        Omega = closed form with fixed cost) */
+    void setDiodeSolver(DiodeFeedbackClipper::Solver solver);
+
+    /** Tolerance / iteration cap of the iterative diode solve */
+    void setDiodeQuality(DiodeFeedbackClipper::Quality quality);
+
+    /** Initial guess and update rule of the iterative diode solve (for benchmarks) */
+    void setDiodePredictor(DiodeFeedbackClipper::Predictor predictor, DiodeFeedbackClipper::Step step);
+
+    /** Diode iterations of both stages and all lanes since the last reset */
+    DiodeFeedbackClipper::IterationStats getIterationStats() const;
+    void resetIterationStats();
+
+    SampleType processSample(SampleType input);
+
+    /** Process a block stage by stage (in == out allowed).
+        The clip-mode branch is taken once per stage instead of per sample. */
+    void process(const SampleType* in, SampleType* out, int numSamples);
+
+    /** Every lane carries the same signal (dual mono): the per-lane work
+        (diode solves, ADAA, the circuit model) runs on lane 0 only and the
+        other lanes repeat it; the interstage filters still run all lanes in
+        one register. Only link lanes whose inputs and state are the same.
+        Unlinking hands lane 0's state to the others, so they carry on
+        exactly where it is. */
+    void setLinkedLanes(bool linked);
+    bool hasLinkedLanes() const { return mLinked; }
+
+    /** Use a specific diode table. */
+    void setDiodeTable(std::shared_ptr<const DiodeTransferTable> table);
+    std::shared_ptr<const DiodeTransferTable> getDiodeTable() const { return mDiodeTable; }
+
+    /** Use a table that may still be building. Until it is ready the Table
+        solver falls back to the exact one (Newton); process() switches over
+        on the first block after. If no table is set, prepare() takes the
+        process-wide one this way (DiodeTransferTable::getSharedAsync()). */
+    void setPendingDiodeTable(std::shared_ptr<const DiodeTransferTable::Future> pending);
+    bool hasDiodeTable() const { return mDiodeTable != nullptr; }
 
     static double applyClip(double x, int mode);
 
 private:
-    DiodeFeedbackClipper mStage1;
-    DiodeFeedbackClipper mStage2;
-    OnePoleFilter mInterstageHPF;
-    OnePoleFilter mInterstageLPF;
+    std::array<DiodeFeedbackClipper, numLanes> mStage1;
+    std::array<DiodeFeedbackClipper, numLanes> mStage2;
+    OnePoleFilter<SampleType> mInterstageHPF;
+    OnePoleFilter<SampleType> mInterstageLPF;
+
+    MT2CircuitModel<SampleType> mCircuit;
+    Engine mEngine = Engine::Classic;
+
+    // Process-wide unless set explicitly, used by both stages and the circuit model
+    std::shared_ptr<const DiodeTransferTable> mDiodeTable;
+    std::shared_ptr<const DiodeTransferTable::Future> mPendingTable;   // kept after the switch: never released on the audio thread
+    void pollDiodeTable();
+    void installDiodeTable(std::shared_ptr<const DiodeTransferTable> table);
+
+    // Previous driven input and its antiderivative, per lane and clip stage
+    struct AdaaState {
+        double x = 0.0;
+        double F = 0.0;
+    };
+    std::array<AdaaState, numLanes> mAdaa1 {};
+    std::array<AdaaState, numLanes> mAdaa2 {};
+    bool mAntialiasing = false;
+    bool mAdaaRestart = true;   // re-seed x1 from the next input (reset / mode change)
 
     int mClipMode = 0;
+    bool mLinked = false;
 };
@@ -1,22 +1,66 @@
 #pragma once
 #include "BiquadFilter.h"
 
+/** Low shelf → mid peak → high shelf. SampleType is double (one channel)
+    or a simd lane type (all lanes share the coefficients).
+
+    Coefficients are only recomputed when a knob moves. A move starts a
+    20 ms linear ramp of the knob value; while it runs, coefficients are
+    redesigned every SUB_BLOCK samples and interpolated per sample in
+    between, so sweeps are smooth without a full redesign per sample. */
+template <typename SampleType>
 class MT2ToneStack {
 public:
+    static constexpr int    SUB_BLOCK = 16;
+    static constexpr double RAMP_SECONDS = 0.02;
+
     MT2ToneStack() = default;
 
+    /** The next updateCoefficients() jumps straight to its values. */
     void prepare(double sampleRate);
     void reset();
 
-    /** Update all EQ coefficients. Call once per block. */
+    /** Samples for the impulse response to fall by decayDb at the knob
+        settings that ring longest, so the value only depends on the rate. */
+    double getMaxTailSamples(double decayDb) const;
+
+    /** Set the EQ knob values (0 … 1). Cheap when nothing changed; call once per block. */
     void updateCoefficients(float eqLow, float eqMid, float eqMidFreq,
                             float eqMidQ, float eqHigh);
 
-    double processSample(double input);
+    SampleType processSample(SampleType input);
+
+    /** Process a block: each biquad runs over the whole block (in == out allowed). */
+    void process(const SampleType* in, SampleType* out, int numSamples);
 
 private:
-    BiquadFilter mLowShelf;
-    BiquadFilter mMidPeak;
-    BiquadFilter mHighShelf;
+    // Linear ramp of one knob value
+    struct Ramp {
+        double current = 0.0;
+        double target = 0.0;
+        double step = 0.0;
+        int remaining = 0;
+
+        void snap(double value) { current = target = value; remaining = 0; }
+        void setTarget(double value, int rampSamples);
+        void advance(int numSamples);
+        bool isRamping() const { return remaining > 0; }
+    };
+
+    enum { LOW, MID, MID_FREQ, MID_Q, HIGH, NUM_KNOBS };
+
+    // Designs for knob values (0 … 1)
+    typename BiquadFilter<SampleType>::Coefficients makeLowShelf(double low) const;
+    typename BiquadFilter<SampleType>::Coefficients makeMidPeak(double mid, double freq, double q) const;
+    typename BiquadFilter<SampleType>::Coefficients makeHighShelf(double high) const;
+
+    BiquadFilter<SampleType> mLowShelf;
+    BiquadFilter<SampleType> mMidPeak;
+    BiquadFilter<SampleType> mHighShelf;
+
+    Ramp mKnobs[NUM_KNOBS];
+    float mLastInput[NUM_KNOBS] = {};
+    bool mNeedsSnap = true;
+
     double mSampleRate = 44100.0;
-};
\ No newline at end of file
+};
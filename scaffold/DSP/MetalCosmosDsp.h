@@ -0,0 +1,99 @@
+#ifndef METALCOSMOS_DSP_H
+#define METALCOSMOS_DSP_H
+
+/* MetalCosmos DSP — plain C interface of the MetalCosmosDsp static library.
+
+   Renders many independent mono streams through the MT-2 chain (pre
+   saturation → oversampled gain stage → tone stack → post saturation)
+   without JUCE or a plugin host. Each stream has its own parameters and
+   state; streams with the same parameters run side by side in SIMD lanes
+   (see MT2BatchEngine).
+
+   Typical use, one job of short streams:
+
+       MT2BatchConfig config;
+       mt2_batch_config_init(&config);
+       config.numStreams = 1000;
+       MT2Batch* batch = mt2_batch_create(&config);
+       for (int s = 0; s < 1000; ++s)
+           mt2_batch_set_stream_params(batch, s, &params[s]);
+       mt2_batch_start(batch);
+       mt2_batch_process(batch, inputs, outputs, numSamples);   // as often as needed
+       mt2_batch_destroy(batch);
+
+   A batch is not thread-safe; use one batch per thread. Functions that
+   return int return MT2_OK or a negative MT2_ERROR_* code. The library is
+   C++ inside: link C programs with the C++ runtime (or a C++ linker). */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    MT2_OK = 0,
+    MT2_ERROR_ARGUMENT = -1,      /* null pointer, stream out of range, bad config */
+    MT2_ERROR_NOT_STARTED = -2,   /* mt2_batch_process before mt2_batch_start */
+    MT2_ERROR_INTERNAL = -3       /* allocation failure or other exception */
+};
+
+/* Per-stream parameters, in the plugin's units (the same defaults). */
+typedef struct MT2StreamParams {
+    float dist;              /* 0 … 1: stage 1 gain 5.6 … 200 */
+    float diodeMorph;        /* 0 … 1: Si → Ge → LED → Schottky → no clip */
+    int   diodeLink;         /* non-zero: stage 2 uses diodeMorph */
+    float diodeMorph2;       /* stage 2 when not linked */
+    int   clipMode;          /* 0 Diode, 1 Tanh, 2 Atan, 3 Hard, 4 Asymmetric, 5 Foldback */
+    int   clipAntialiasing;  /* non-zero: ADAA for clip modes 1-5 */
+    int   circuitModel;      /* non-zero: Diode mode through the circuit model */
+    int   diodeSolver;       /* 0 Newton, 1 Table, 2 Omega */
+    int   solverQuality;     /* 0 Eco, 1 Normal, 2 High */
+    float eqLow;             /* tone stack knobs, 0 … 1 */
+    float eqMid;
+    float eqMidFreq;
+    float eqMidQ;
+    float eqHigh;
+    float satAmount;         /* 0 … 1 */
+    int   satPosition;       /* 0 before the gain stage, 1 after the tone stack, 2 off */
+} MT2StreamParams;
+
+/* Shared by every stream of a batch. */
+typedef struct MT2BatchConfig {
+    int    numStreams;
+    double sampleRate;
+    int    maxBlockSize;            /* longer process calls are split internally */
+    int    oversamplingFactorLog2;  /* 0 … 3 (1x … 8x) */
+    int    minimumPhase;            /* non-zero: minimum-phase oversampling filters */
+    int    renderProfile;           /* non-zero: as an offline bounce of the plugin
+                                       (long filters, at least 4x, exact diode solve) */
+} MT2BatchConfig;
+
+typedef struct MT2Batch MT2Batch;
+
+void mt2_stream_params_init(MT2StreamParams* params);
+void mt2_batch_config_init(MT2BatchConfig* config);
+
+/* NULL on a bad config or failure. Loads the shared tables (blocks for the
+   first batch in the process if the diode table has to be built). */
+MT2Batch* mt2_batch_create(const MT2BatchConfig* config);
+void mt2_batch_destroy(MT2Batch* batch);
+
+/* Takes effect at the next mt2_batch_start. */
+int mt2_batch_set_stream_params(MT2Batch* batch, int stream, const MT2StreamParams* params);
+
+/* Groups the streams by parameters and starts every stream from silence
+   (allocates). Call again to begin the next job. */
+int mt2_batch_start(MT2Batch* batch);
+
+/* One input and one output pointer per stream, numSamples each (an input
+   may be the same buffer as its output). Does not allocate. */
+int mt2_batch_process(MT2Batch* batch, const float* const* inputs, float* const* outputs, int numSamples);
+int mt2_batch_process_double(MT2Batch* batch, const double* const* inputs, double* const* outputs, int numSamples);
+
+/* Delay of the output in samples (oversampling filters); the same for every stream. */
+int mt2_batch_get_latency(const MT2Batch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,9 @@
 #pragma once
+#include "SimdLanes.h"
 
+/** First-order TPT filter. SampleType is double (one channel) or a
+    simd lane type (several channels sharing the coefficients). */
+template <typename SampleType>
 class OnePoleFilter {
 public:
     enum class Type { HPF, LPF };
@@ -11,11 +15,17 @@ public:
     void setCutoffFrequency(double freqHz, double sampleRate);
     void reset();
 
-    double processSample(double input);
+    /** Samples for the impulse response to fall by decayDb */
+    double getTailSamples(double decayDb) const;
+
+    SampleType processSample(SampleType input);
+
+    /** Process a block (in == out allowed). */
+    void process(const SampleType* in, SampleType* out, int numSamples);
 
 private:
     Type   mType = Type::LPF;
     double mA0 = 1.0;
     double mB1 = 0.0;
-    double mZ1 = 0.0;
-};
\ No newline at end of file
+    SampleType mZ1 {};
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include "SimdLanes.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+/** Polyphase half-band 2x stage, linear phase.
+    Symmetric FIR of 4K-1 taps (Kaiser-windowed sinc); every other tap is
+    zero except the centre (0.5), so each output costs K multiplies. */
+template <typename SampleType>
+class HalfBandFIR {
+public:
+    /** numCoefs = K, attenuation in dB sets the Kaiser window. The kernel is
+        shared process-wide (SharedTables). Not real-time safe. */
+    void design(int numCoefs, double attenuationDb);
+    void prepare(int maxInputSamples);
+    void reset();
+
+    /** numSamples in → 2·numSamples out */
+    void upsample(const SampleType* in, SampleType* out, int numSamples);
+    /** 2·numSamples in → numSamples out (in == out allowed) */
+    void downsample(const SampleType* in, SampleType* out, int numSamples);
+
+    /** Group delay of upsample + downsample, in samples at the 2x rate */
+    int getLatency() const { return 4 * static_cast<int>(mCoefs->size()) - 2; }
+
+    /** Impulse response length of upsample + downsample, at the 2x rate */
+    int getTailSamples() const { return 2 * getLatency(); }
+
+private:
+    std::shared_ptr<const std::vector<double>> mCoefs;   // K unique non-centre taps (SharedTables)
+    std::vector<SampleType> mUpWork;    // [history (2K-1) | block]
+    std::vector<SampleType> mDownWork;  // [history (4K-2) | 2·block]
+};
+
+/** Polyphase half-band 2x stage, minimum phase.
+    Two parallel chains of first-order allpass sections in z^-2 (elliptic
+    design after Valenzuela & Constantinides): a few multiplies per sample
+    and a group delay of only a couple of samples, at the cost of phase
+    distortion near the band edge. */
+template <typename SampleType>
+class HalfBandIIR {
+public:
+    static constexpr int MAX_COEFS = 12;
+
+    /** numCoefs allpass sections split over the two paths; transition is the
+        half-width of the transition band relative to the 2x rate (0 … 0.5). */
+    void design(int numCoefs, double transition);
+    void reset();
+
+    void upsample(const SampleType* in, SampleType* out, int numSamples);
+    void downsample(const SampleType* in, SampleType* out, int numSamples);
+
+    /** Group delay at DC of upsample + downsample, in samples at the 2x rate */
+    double getLatency() const;
+
+    /** Samples at the 2x rate for the impulse response of upsample +
+        downsample to fall by decayDb (bounded by summing the sections) */
+    double getTailSamples(double decayDb) const;
+
+private:
+    // Coefficient i belongs to path i % 2; both paths advance together
+    struct Chain {
+        std::array<SampleType, MAX_COEFS> x {};
+        std::array<SampleType, MAX_COEFS> y {};
+        void process(const double* coefs, int numCoefs, SampleType& even, SampleType& odd);
+    };
+
+    std::array<double, MAX_COEFS> mCoefs {};
+    int mNumCoefs = 0;
+    Chain mUp, mDown;
+};
+
+/** 2x / 4x / 8x oversampler built from cascaded half-band stages.
+    Typical use per block:
+        auto* os = oversampler.processUp(in, n);      // n·factor samples
+        ... nonlinear processing on os ...
+        oversampler.processDown(out, n);
+    Linear phase reports an exact integer latency (a short delay at the top
+    rate pads the fractional part); minimum phase reports its group delay at
+    DC rounded to the nearest sample. With the Live designs that is 63 / 71 /
+    73 (linear) and 3 / 4 / 5 (minimum) base-rate samples for 2x / 4x / 8x. */
+template <typename SampleType>
+class Oversampler {
+public:
+    enum class Phase { Linear, Minimum };
+    static constexpr int MAX_STAGES = 3;   // 8x
+
+    /** Live: the half-band designs below, sized for real-time CPU.
+        Render: longer kernels with deeper stopbands and narrower transition
+        bands, for offline bounces where CPU time does not matter. The two
+        differ in latency. */
+    enum class Quality { Live, Render };
+
+    Oversampler();
+
+    /** Allocates for every factor up to 8x. Not real-time safe. */
+    void prepare(int maxBlockSize);
+    void reset();
+
+    /** Redesigns every stage (and re-prepares them if prepare() was called).
+        Not real-time safe; state is reset on change. */
+    void setQuality(Quality quality);
+    Quality getQuality() const { return mQuality; }
+
+    /** factorLog2: 0 = 1x … 3 = 8x. Real-time safe; state is reset on change. */
+    void setConfig(int factorLog2, Phase phase);
+
+    int getFactor() const { return 1 << mNumStages; }
+    int getNumStages() const { return mNumStages; }
+    Phase getPhase() const { return mPhase; }
+
+    /** Latency of the up/down pair in base-rate samples. */
+    int getLatencySamples() const;
+
+    /** Base-rate samples for the up/down pair's impulse response to fall by decayDb */
+    double getTailSamples(double decayDb) const;
+
+    /** Upsample numSamples (≤ maxBlockSize); returns numSamples·factor samples
+        owned by the oversampler. With factor 1 the input is copied. */
+    SampleType* processUp(const SampleType* in, int numSamples);
+
+    /** Downsample the buffer returned by processUp into numSamples of out. */
+    void processDown(SampleType* out, int numSamples);
+
+private:
+    void updatePadding();
+
+    std::array<HalfBandFIR<SampleType>, MAX_STAGES> mFir;
+    std::array<HalfBandIIR<SampleType>, MAX_STAGES> mIir;
+    std::array<std::vector<SampleType>, MAX_STAGES + 1> mBuffers;   // [k] holds 2^k·block
+
+    // Linear phase: pads the fractional part of the latency at the top rate
+    std::array<SampleType, 8> mPad {};
+    int mPadLength = 0;
+    int mPadPos = 0;
+
+    int mNumStages = 0;
+    Phase mPhase = Phase::Linear;
+    Quality mQuality = Quality::Live;
+    int mMaxBlockSize = 0;
+};
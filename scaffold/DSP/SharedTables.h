@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeindex>
+
+/** Process-wide registry of immutable DSP tables.
+
+    Every plugin instance in a process (hosts load dozens) asks the registry
+    instead of building its own copy: the first caller builds, later callers
+    get the same object, and the entry is freed when the last instance
+    releases it (the registry only holds weak references). Tables are
+    const once built, so instances read them concurrently without locks.
+
+    Lookups lock a mutex and may build, so they belong in constructors and
+    prepare(), never on the audio thread. A build function must not call
+    get() itself. Tables too slow to build in prepare() go through
+    getAsync(): the caller gets a Future at once and the table is built on
+    a background thread.
+*/
+class SharedTables {
+public:
+    struct Key {
+        std::string kind;          // what the table is, e.g. "diode-transfer"
+        double sampleRate = 0.0;   // 0 for rate-independent tables
+        int quality = 0;           // size / precision variant
+        double detail = 0.0;       // any further design parameter
+
+        bool operator<(const Key& other) const;
+    };
+
+    /** The table for key, built with build() if no instance holds it yet. */
+    template <typename Table, typename Build>
+    static std::shared_ptr<const Table> get(const Key& key, Build&& build)
+    {
+        return std::static_pointer_cast<const Table>(
+            getErased(typeid(Table), key, [&build]() -> std::shared_ptr<const void> { return build(); }));
+    }
+
+    /** A table being built on its own background thread.
+
+        tryGet() is lock-free and allocation-free, so the audio thread can
+        poll it once per block and switch over when the table is ready. The
+        destructor waits for a build still in progress. */
+    template <typename Table>
+    class Future {
+    public:
+        using Build = std::function<std::shared_ptr<const Table>()>;
+
+        explicit Future(Build build)
+        {
+            mThread = std::thread([this, build = std::move(build)] {
+                auto table = build();
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mTable = std::move(table);
+                    mReady.store(true, std::memory_order_release);
+                }
+                mBuilt.notify_all();
+            });
+        }
+
+        ~Future() { mThread.join(); }
+
+        Future(const Future&) = delete;
+        Future& operator=(const Future&) = delete;
+
+        /** The table, or nullptr while it is still being built. Real-time safe:
+            the table is never written again once ready. */
+        std::shared_ptr<const Table> tryGet() const
+        {
+            return mReady.load(std::memory_order_acquire) ? mTable : nullptr;
+        }
+
+        /** Blocks until the table is built (offline rendering, tools). */
+        std::shared_ptr<const Table> wait() const
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mBuilt.wait(lock, [this] { return mReady.load(std::memory_order_relaxed); });
+            return mTable;
+        }
+
+    private:
+        mutable std::mutex mMutex;
+        mutable std::condition_variable mBuilt;
+        std::atomic<bool> mReady { false };
+        std::shared_ptr<const Table> mTable;
+        std::thread mThread;
+    };
+
+    /** Like get(), but returns immediately: the first caller starts build()
+        on a background thread, later callers share its Future. */
+    template <typename Table, typename Build>
+    static std::shared_ptr<const Future<Table>> getAsync(const Key& key, Build&& build)
+    {
+        return get<Future<Table>>(key, [&build] {
+            return std::make_shared<const Future<Table>>(typename Future<Table>::Build(std::forward<Build>(build)));
+        });
+    }
+
+    /** Live entries (for tests and benchmarks) */
+    static int getNumEntries();
+
+private:
+    static std::shared_ptr<const void> getErased(std::type_index type, const Key& key,
+                                                 const std::function<std::shared_ptr<const void>()>& build);
+};
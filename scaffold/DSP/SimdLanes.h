@@ -0,0 +1,152 @@
+#pragma once
+
+// SIMD lane types for running independent channels through the same DSP in
+// lockstep. Coefficients stay scalar (double); only signal and state are
+// vectors. Lanes<T> gives a uniform interface so DSP templates also accept
+// plain double (one lane).
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MT2_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define MT2_SIMD_NEON 1
+#endif
+
+// Double4 uses one AVX register when the build targets AVX (METALCOSMOS_AVX),
+// otherwise two Double2 registers
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define MT2_SIMD_AVX 1
+#endif
+
+namespace simd {
+
+/** Two doubles in one SSE2 / NEON register (plain array elsewhere). */
+struct alignas(16) Double2 {
+#if MT2_SIMD_SSE2
+    __m128d v;
+#elif MT2_SIMD_NEON
+    float64x2_t v;
+#else
+    double v[2];
+#endif
+};
+
+static_assert(sizeof(Double2) == 2 * sizeof(double), "Double2 must be two packed doubles");
+
+#if MT2_SIMD_SSE2
+inline Double2 operator+(Double2 a, Double2 b) { return { _mm_add_pd(a.v, b.v) }; }
+inline Double2 operator-(Double2 a, Double2 b) { return { _mm_sub_pd(a.v, b.v) }; }
+inline Double2 operator*(Double2 a, Double2 b) { return { _mm_mul_pd(a.v, b.v) }; }
+inline Double2 operator*(double a, Double2 b)  { return { _mm_mul_pd(_mm_set1_pd(a), b.v) }; }
+#elif MT2_SIMD_NEON
+inline Double2 operator+(Double2 a, Double2 b) { return { vaddq_f64(a.v, b.v) }; }
+inline Double2 operator-(Double2 a, Double2 b) { return { vsubq_f64(a.v, b.v) }; }
+inline Double2 operator*(Double2 a, Double2 b) { return { vmulq_f64(a.v, b.v) }; }
+inline Double2 operator*(double a, Double2 b)  { return { vmulq_n_f64(b.v, a) }; }
+#else
+inline Double2 operator+(Double2 a, Double2 b) { return {{ a.v[0] + b.v[0], a.v[1] + b.v[1] }}; }
+inline Double2 operator-(Double2 a, Double2 b) { return {{ a.v[0] - b.v[0], a.v[1] - b.v[1] }}; }
+inline Double2 operator*(Double2 a, Double2 b) { return {{ a.v[0] * b.v[0], a.v[1] * b.v[1] }}; }
+inline Double2 operator*(double a, Double2 b)  { return {{ a * b.v[0], a * b.v[1] }}; }
+#endif
+inline Double2 operator*(Double2 a, double b) { return b * a; }
+
+/** Four doubles: one AVX register, or a pair of Double2. */
+struct alignas(32) Double4 {
+#if MT2_SIMD_AVX
+    __m256d v;
+#else
+    Double2 lo, hi;
+#endif
+};
+
+static_assert(sizeof(Double4) == 4 * sizeof(double), "Double4 must be four packed doubles");
+
+#if MT2_SIMD_AVX
+inline Double4 operator+(Double4 a, Double4 b) { return { _mm256_add_pd(a.v, b.v) }; }
+inline Double4 operator-(Double4 a, Double4 b) { return { _mm256_sub_pd(a.v, b.v) }; }
+inline Double4 operator*(Double4 a, Double4 b) { return { _mm256_mul_pd(a.v, b.v) }; }
+inline Double4 operator*(double a, Double4 b)  { return { _mm256_mul_pd(_mm256_set1_pd(a), b.v) }; }
+#else
+inline Double4 operator+(Double4 a, Double4 b) { return { a.lo + b.lo, a.hi + b.hi }; }
+inline Double4 operator-(Double4 a, Double4 b) { return { a.lo - b.lo, a.hi - b.hi }; }
+inline Double4 operator*(Double4 a, Double4 b) { return { a.lo * b.lo, a.hi * b.hi }; }
+inline Double4 operator*(double a, Double4 b)  { return { a * b.lo, a * b.hi }; }
+#endif
+inline Double4 operator*(Double4 a, double b) { return b * a; }
+
+/** Per-type lane access. The lanes of a block of T are stored contiguously,
+    so a T* can be viewed as an interleaved double array with stride count. */
+template <typename T> struct Lanes;
+
+template <> struct Lanes<double> {
+    static constexpr int count = 1;
+    static double broadcast(double x) { return x; }
+    static double get(double v, int) { return v; }
+};
+
+template <> struct Lanes<Double2> {
+    static constexpr int count = 2;
+
+    static Double2 broadcast(double x) {
+#if MT2_SIMD_SSE2
+        return { _mm_set1_pd(x) };
+#elif MT2_SIMD_NEON
+        return { vdupq_n_f64(x) };
+#else
+        return {{ x, x }};
+#endif
+    }
+
+    static Double2 make(double lane0, double lane1) {
+#if MT2_SIMD_SSE2
+        return { _mm_set_pd(lane1, lane0) };
+#elif MT2_SIMD_NEON
+        return { vcombine_f64(vdup_n_f64(lane0), vdup_n_f64(lane1)) };
+#else
+        return {{ lane0, lane1 }};
+#endif
+    }
+
+    static double get(Double2 v, int lane) {
+        return reinterpret_cast<const double*>(&v)[lane];
+    }
+};
+
+template <> struct Lanes<Double4> {
+    static constexpr int count = 4;
+
+    static Double4 broadcast(double x) {
+#if MT2_SIMD_AVX
+        return { _mm256_set1_pd(x) };
+#else
+        return { Lanes<Double2>::broadcast(x), Lanes<Double2>::broadcast(x) };
+#endif
+    }
+
+    static Double4 make(double lane0, double lane1, double lane2, double lane3) {
+#if MT2_SIMD_AVX
+        return { _mm256_set_pd(lane3, lane2, lane1, lane0) };
+#else
+        return { Lanes<Double2>::make(lane0, lane1), Lanes<Double2>::make(lane2, lane3) };
+#endif
+    }
+
+    static double get(Double4 v, int lane) {
+        return reinterpret_cast<const double*>(&v)[lane];
+    }
+};
+
+/** View a block of lane vectors as interleaved doubles. */
+template <typename T> inline double* flat(T* p) { return reinterpret_cast<double*>(p); }
+template <typename T> inline const double* flat(const T* p) { return reinterpret_cast<const double*>(p); }
+
+/** Repeat lane 0 of every sample of a block in all other lanes. */
+template <typename T> inline void copyFirstLane(T* block, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+        block[i] = Lanes<T>::broadcast(Lanes<T>::get(block[i], 0));
+}
+
+} // namespace simd
@@ -105,6 +105,67 @@ namespace MT2Params {
                 })
         ));
 
+        // Diode Solver: ダイオード方程式の解法
+        // (0=Exact: Newton-Raphson, 1=Table: 事前計算カーブ, 2=Omega: Wright omega 閉形式, 固定コスト)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"diode_solver", 1},
+            "Diode Solver",
+            juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f),
+            1.0f,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float v, int) {
+                    const char* names[] = {"Exact", "Table", "Omega"};
+                    return juce::String(names[std::clamp((int)v, 0, 2)]);
+                })
+        ));
+
+        // Solver Quality: 反復解法の収束許容誤差と最大反復回数 (0=Eco, 1=Normal, 2=High)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"solver_quality", 1},
+            "Solver Quality",
+            juce::NormalisableRange<float>(0.0f, 2.0f, 1.0f),
+            1.0f,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float v, int) {
+                    const char* names[] = {"Eco", "Normal", "High"};
+                    return juce::String(names[std::clamp((int)v, 0, 2)]);
+                })
+        ));
+
+        // Clip ADAA: 静的クリップモード (Tanh〜Foldback) の一次 antiderivative anti-aliasing
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID{"clip_adaa", 1}, "Clip ADAA", true));
+
+        // Circuit Model: Diode モードのゲイン段を回路全体の状態空間モデル (DK 法) で計算
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID{"circuit_model", 1}, "Circuit Model", false));
+
+        // Oversampling: ゲインステージのオーバーサンプリング倍率 (0=1x, 1=2x, 2=4x, 3=8x)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"os_factor", 1},
+            "Oversampling",
+            juce::NormalisableRange<float>(0.0f, 3.0f, 1.0f),
+            1.0f,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float v, int) {
+                    const char* names[] = {"1x", "2x", "4x", "8x"};
+                    return juce::String(names[std::clamp((int)v, 0, 3)]);
+                })
+        ));
+
+        // Oversampling Phase: ハーフバンドフィルタの位相特性 (0=Linear: FIR, 1=MinPhase: 低レイテンシ IIR)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"os_phase", 1},
+            "OS Phase",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 1.0f),
+            0.0f,
+            juce::AudioParameterFloatAttributes{}
+                .withStringFromValueFunction([](float v, int) {
+                    const char* names[] = {"Linear", "MinPhase"};
+                    return juce::String(names[std::clamp((int)v, 0, 1)]);
+                })
+        ));
+
         return { params.begin(), params.end() };
     }
 
@@ -0,0 +1,530 @@
+// MetalCosmosDspTests — golden-output and CPU-budget tests of the DSP chain
+//
+// Links the DSP sources directly (no JUCE, no plugin host). Every
+// configuration renders the same fixed signals (sine, log sweep, impulse,
+// noise) through MT2ChannelChain, each from a reset chain.
+//
+// Usage:
+//   MetalCosmosDspTests golden <referenceDir>   compare with the stored references
+//   MetalCosmosDspTests update <referenceDir>   rewrite the references (after an
+//                                               intended change of the sound)
+//   MetalCosmosDspTests performance             every configuration within its
+//                                               CPU budget (optimised builds only,
+//                                               otherwise exits 77 = skipped;
+//                                               METALCOSMOS_BUDGET_SCALE=2 doubles
+//                                               the budgets on slow machines)
+//   MetalCosmosDspTests batch                   streams rendered together through
+//                                               the C interface match each stream
+//                                               rendered alone
+//   MetalCosmosDspTests level                   the chain's level is the same at
+//                                               every oversampling factor
+
+#include "DSP/DiodeMorpher.h"
+#include "DSP/DiodeTransferTable.h"
+#include "DSP/MT2ChannelChain.h"
+#include "DSP/MetalCosmosDsp.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+//==============================================================================
+constexpr double kSampleRate = 48000.0;
+constexpr int kBlockSize = 160;           // not a power of two: blocks straddle the signal edges
+constexpr int kSignalLength = 1024;       // samples per test signal
+constexpr double kTolerance = 1.0e-4;     // max |output - reference| (-80 dBFS)
+constexpr double kDistGain = 33.5;        // dist = 0.5
+
+struct Config {
+    std::string name;
+    int clipMode = 0;                     // 0 = Diode, 1-5 = static curves
+    bool circuit = false;                 // Diode mode through MT2CircuitModel
+    float morph1 = 0.0f;                  // DiodeMorpher value, stage 1
+    float morph2 = -1.0f;                 // stage 2; < 0 = linked to stage 1
+    float eq[5] = { 0.5f, 0.5f, 0.5f, 0.3f, 0.5f };   // low, mid, mid freq, mid Q, high
+    DiodeFeedbackClipper::Solver solver = DiodeFeedbackClipper::Solver::Table;
+    DiodeFeedbackClipper::Quality quality = DiodeFeedbackClipper::Quality::Normal;
+    double cpuBudget = 0.0;               // max share of real time, one channel at 48 kHz
+};
+
+// Budgets are about 4x what a 2020s desktop core needs, so only real
+// regressions (or a debug build) trip them
+std::vector<Config> makeConfigs()
+{
+    using Solver = DiodeFeedbackClipper::Solver;
+    using Quality = DiodeFeedbackClipper::Quality;
+
+    std::vector<Config> configs;
+    auto add = [&configs](Config c) { configs.push_back(std::move(c)); return &configs.back(); };
+
+    // Clip modes (Si diodes, flat EQ)
+    add({ "clip-diode" })->cpuBudget = 0.030;
+    add({ "clip-tanh", 1 })->cpuBudget = 0.040;
+    add({ "clip-atan", 2 })->cpuBudget = 0.040;
+    add({ "clip-hard", 3 })->cpuBudget = 0.040;
+    add({ "clip-asym", 4 })->cpuBudget = 0.040;
+    add({ "clip-sine", 5 })->cpuBudget = 0.040;
+
+    // Diode engines and solvers
+    add({ "diode-circuit", 0, true })->cpuBudget = 0.050;
+    auto* newton = add({ "diode-newton" });
+    newton->solver = Solver::Newton;
+    newton->quality = Quality::High;
+    newton->cpuBudget = 0.150;
+    auto* omega = add({ "diode-omega" });
+    omega->solver = Solver::Omega;
+    omega->cpuBudget = 0.100;
+
+    // Diode morph: the middle of every region, the clean end, and unlinked stages
+    add({ "morph-si-ge", 0, false, 0.125f })->cpuBudget = 0.030;
+    add({ "morph-ge-led", 0, false, 0.375f })->cpuBudget = 0.030;
+    add({ "morph-led-schottky", 0, false, 0.625f })->cpuBudget = 0.030;
+    add({ "morph-schottky-noclip", 0, false, 0.875f })->cpuBudget = 0.030;
+    add({ "morph-noclip", 0, false, 1.0f })->cpuBudget = 0.030;
+    add({ "morph-unlinked", 0, false, 0.25f, 0.5f })->cpuBudget = 0.030;
+
+    // EQ extremes
+    add({ "eq-low-boost", 0, false, 0.0f, -1.0f, { 1.0f, 0.5f, 0.5f, 0.3f, 0.5f } })->cpuBudget = 0.030;
+    add({ "eq-low-cut", 0, false, 0.0f, -1.0f, { 0.0f, 0.5f, 0.5f, 0.3f, 0.5f } })->cpuBudget = 0.030;
+    add({ "eq-mid-boost-narrow", 0, false, 0.0f, -1.0f, { 0.5f, 1.0f, 0.3f, 1.0f, 0.5f } })->cpuBudget = 0.030;
+    add({ "eq-mid-cut-wide", 0, false, 0.0f, -1.0f, { 0.5f, 0.0f, 0.7f, 0.0f, 0.5f } })->cpuBudget = 0.030;
+    add({ "eq-high-boost", 0, false, 0.0f, -1.0f, { 0.5f, 0.5f, 0.5f, 0.3f, 1.0f } })->cpuBudget = 0.030;
+    add({ "eq-high-cut", 0, false, 0.0f, -1.0f, { 0.5f, 0.5f, 0.5f, 0.3f, 0.0f } })->cpuBudget = 0.030;
+
+    return configs;
+}
+
+//==============================================================================
+// Test signals. Noise comes from mt19937 directly (the standard
+// distributions differ between library implementations).
+struct Signal {
+    std::string name;
+    std::vector<double> samples;
+};
+
+std::vector<Signal> makeSignals()
+{
+    std::vector<Signal> signals;
+    std::vector<double> x(static_cast<size_t>(kSignalLength));
+
+    for (int i = 0; i < kSignalLength; ++i)
+        x[static_cast<size_t>(i)] = 0.5 * std::sin(2.0 * M_PI * 110.0 * i / kSampleRate);
+    signals.push_back({ "sine", x });
+
+    // Exponential sweep 20 Hz → 20 kHz
+    const double f0 = 20.0, f1 = 20000.0;
+    const double duration = kSignalLength / kSampleRate;
+    const double rate = std::log(f1 / f0);
+    for (int i = 0; i < kSignalLength; ++i) {
+        const double t = i / kSampleRate;
+        const double phase = 2.0 * M_PI * f0 * duration / rate * (std::exp(t / duration * rate) - 1.0);
+        x[static_cast<size_t>(i)] = 0.5 * std::sin(phase);
+    }
+    signals.push_back({ "sweep", x });
+
+    std::fill(x.begin(), x.end(), 0.0);
+    x[64] = 1.0;
+    signals.push_back({ "impulse", x });
+
+    std::mt19937 rng(0x4d54);
+    for (auto& sample : x)
+        sample = 0.3 * (static_cast<double>(rng()) / 4294967296.0 * 2.0 - 1.0);
+    signals.push_back({ "noise", x });
+
+    return signals;
+}
+
+//==============================================================================
+void configure(MT2ChannelChain<double>& chain, const Config& config)
+{
+    // The table is set up front: waiting for the background build would
+    // make the first blocks depend on timing
+    auto& gainStage = chain.getGainStage();
+    gainStage.setDiodeTable(DiodeTransferTable::getShared());
+
+    chain.prepare(kSampleRate, kBlockSize);
+    chain.setOversampling(1, false);
+
+    const DiodeMorpher morpher;
+    const auto stage1 = morpher.getMorphedParams(config.morph1);
+    const auto stage2 = config.morph2 < 0.0f ? stage1 : morpher.getMorphedParams(config.morph2);
+    gainStage.setGain(kDistGain);
+    gainStage.setStage1Diode(stage1.is, stage1.n, stage1.noClip);
+    gainStage.setStage2Diode(stage2.is, stage2.n, stage2.noClip);
+    gainStage.setClipMode(config.clipMode);
+    gainStage.setAntialiasing(true);
+    gainStage.setEngine(config.circuit ? MT2GainStage<double>::Engine::Circuit : MT2GainStage<double>::Engine::Classic);
+    gainStage.setDiodeSolver(config.solver);
+    gainStage.setDiodeQuality(config.quality);
+
+    const auto& eq = config.eq;
+    chain.getToneStack().updateCoefficients(eq[0], eq[1], eq[2], eq[3], eq[4]);
+}
+
+void process(MT2ChannelChain<double>& chain, const double* in, double* out, int numSamples)
+{
+    const MT2Saturator noSat(0.0f);
+    for (int pos = 0; pos < numSamples; pos += kBlockSize) {
+        const int n = std::min(kBlockSize, numSamples - pos);
+        const double* block = in + pos;
+        double* outBlock = out + pos;
+        chain.pack(&block, 1, n, noSat);
+        chain.processGainStage(n);
+        chain.processToneStack(n);
+        chain.unpack(&outBlock, 1, n, noSat);
+    }
+}
+
+// Every signal from a reset chain, back to back
+std::vector<float> render(const Config& config, const std::vector<Signal>& signals)
+{
+    MT2ChannelChain<double> chain;
+    configure(chain, config);
+
+    std::vector<float> result;
+    std::vector<double> out(static_cast<size_t>(kSignalLength));
+    for (const auto& signal : signals) {
+        chain.reset();
+        process(chain, signal.samples.data(), out.data(), kSignalLength);
+        result.insert(result.end(), out.begin(), out.end());
+    }
+    return result;
+}
+
+//==============================================================================
+// Reference files: float32, little endian, no header
+std::string referencePath(const std::string& dir, const Config& config)
+{
+    return dir + "/" + config.name + ".f32";
+}
+
+bool writeReference(const std::string& path, const std::vector<float>& samples)
+{
+    std::ofstream file(path, std::ios::binary);
+    for (float sample : samples) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &sample, sizeof(bits));
+        const char bytes[4] = { static_cast<char>(bits), static_cast<char>(bits >> 8),
+                                static_cast<char>(bits >> 16), static_cast<char>(bits >> 24) };
+        file.write(bytes, 4);
+    }
+    return static_cast<bool>(file);
+}
+
+bool readReference(const std::string& path, std::vector<float>& samples)
+{
+    std::ifstream file(path, std::ios::binary);
+    unsigned char bytes[4];
+    samples.clear();
+    while (file.read(reinterpret_cast<char*>(bytes), 4)) {
+        const std::uint32_t bits = static_cast<std::uint32_t>(bytes[0]) | static_cast<std::uint32_t>(bytes[1]) << 8
+                                 | static_cast<std::uint32_t>(bytes[2]) << 16 | static_cast<std::uint32_t>(bytes[3]) << 24;
+        float sample;
+        std::memcpy(&sample, &bits, sizeof(sample));
+        samples.push_back(sample);
+    }
+    return file.eof() && !samples.empty();
+}
+
+int runGolden(const std::string& dir, bool update)
+{
+    const auto signals = makeSignals();
+    int failures = 0;
+
+    for (const auto& config : makeConfigs()) {
+        const auto output = render(config, signals);
+        const auto path = referencePath(dir, config);
+
+        if (update) {
+            if (!writeReference(path, output)) {
+                std::cerr << "cannot write " << path << std::endl;
+                return 1;
+            }
+            std::cout << "wrote " << path << std::endl;
+            continue;
+        }
+
+        std::vector<float> reference;
+        if (!readReference(path, reference) || reference.size() != output.size()) {
+            std::cout << "FAIL " << config.name << ": missing or wrong-size reference " << path
+                      << " (run `MetalCosmosDspTests update <dir>` after an intended change)" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        // Worst sample per signal
+        bool ok = true;
+        std::ostringstream report;
+        for (size_t s = 0; s < signals.size(); ++s) {
+            double worst = 0.0;
+            int worstIndex = 0;
+            for (int i = 0; i < kSignalLength; ++i) {
+                const size_t k = s * static_cast<size_t>(kSignalLength) + static_cast<size_t>(i);
+                const double error = std::abs(static_cast<double>(output[k]) - static_cast<double>(reference[k]));
+                if (!(error <= worst)) {   // also catches NaN
+                    worst = error;
+                    worstIndex = i;
+                }
+            }
+            if (!(worst <= kTolerance)) {
+                ok = false;
+                report << " " << signals[s].name << " off by " << worst << " at sample " << worstIndex << ";";
+            }
+        }
+
+        std::cout << (ok ? "ok   " : "FAIL ") << config.name << report.str() << std::endl;
+        failures += ok ? 0 : 1;
+    }
+
+    if (!update)
+        std::cout << failures << " of " << makeConfigs().size() << " configurations differ from the references" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+//==============================================================================
+// Exit code ctest reports as "Skipped" (SKIP_RETURN_CODE in CMakeLists.txt)
+constexpr int kSkipped = 77;
+
+#ifdef NDEBUG
+// One second of a guitar-like signal, best of several runs
+double measureRealtimeShare(const Config& config)
+{
+    const int numSamples = static_cast<int>(kSampleRate);
+    std::vector<double> in(static_cast<size_t>(numSamples)), out(in.size());
+    std::mt19937 rng(0x4d54);
+    for (int i = 0; i < numSamples; ++i) {
+        const double t = i / kSampleRate;
+        in[static_cast<size_t>(i)] = 0.4 * std::sin(2.0 * M_PI * 110.0 * t) + 0.2 * std::sin(2.0 * M_PI * 220.7 * t)
+                                   + 0.05 * (static_cast<double>(rng()) / 4294967296.0 * 2.0 - 1.0);
+    }
+
+    MT2ChannelChain<double> chain;
+    configure(chain, config);
+    process(chain, in.data(), out.data(), numSamples);   // warm up
+
+    double best = 1.0e9;
+    for (int run = 0; run < 5; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        process(chain, in.data(), out.data(), numSamples);
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best * kSampleRate / numSamples;
+}
+#endif
+
+int runPerformance()
+{
+#ifndef NDEBUG
+    std::cout << "skipped: CPU budgets only apply to optimised builds" << std::endl;
+    return kSkipped;
+#else
+    double scale = 1.0;
+    if (const char* env = std::getenv("METALCOSMOS_BUDGET_SCALE"))
+        scale = std::max(1.0, std::atof(env));
+
+    int failures = 0;
+    for (const auto& config : makeConfigs()) {
+        const double share = measureRealtimeShare(config);
+        const double budget = config.cpuBudget * scale;
+        const bool ok = share <= budget;
+        std::cout << (ok ? "ok   " : "FAIL ") << std::left << std::setw(24) << config.name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(6) << share * 100.0 << " % of real time (budget "
+                  << budget * 100.0 << " %)" << std::endl;
+        failures += ok ? 0 : 1;
+    }
+    return failures == 0 ? 0 : 1;
+#endif
+}
+
+//==============================================================================
+// Oversampling must not change the sound: a 110 Hz sine comes out at the same
+// level (RMS) from 1x to 8x. A filter whose gain follows the processing rate
+// (rather than its cutoff) shows up here as a step per factor.
+constexpr double kLevelTolerance = 0.001;
+
+double measureLevel(double amplitude, double gain, int factorLog2, bool minimumPhase)
+{
+    MT2ChannelChain<double> chain;
+    configure(chain, Config { "level" });
+    chain.setOversampling(factorLog2, minimumPhase);
+    chain.getGainStage().setGain(gain);
+    chain.reset();
+
+    const int numSamples = static_cast<int>(kSampleRate / 2);
+    std::vector<double> in(static_cast<size_t>(numSamples)), out(in.size());
+    for (int i = 0; i < numSamples; ++i)
+        in[static_cast<size_t>(i)] = amplitude * std::sin(2.0 * M_PI * 110.0 * i / kSampleRate);
+    process(chain, in.data(), out.data(), numSamples);
+
+    // RMS of the second half (27 periods of 110 Hz): the filters and the
+    // oversampler have settled. The peak would also follow the phase of the
+    // harmonics, which the minimum-phase filters shift with the factor.
+    const size_t start = out.size() / 2;
+    double sum = 0.0;
+    for (size_t i = start; i < out.size(); ++i)
+        sum += out[i] * out[i];
+    return std::sqrt(sum / static_cast<double>(out.size() - start));
+}
+
+int runLevel()
+{
+    int failures = 0;
+    for (const bool minimumPhase : { false, true }) {
+        for (const float dist : { 0.0f, 0.5f, 1.0f }) {
+            for (const double amplitude : { 0.5, 0.05, 0.005 }) {
+                const double gain = MT2GainStage<double>::gainForDist(dist);
+                double levels[4];
+                for (int factorLog2 = 0; factorLog2 < 4; ++factorLog2)
+                    levels[factorLog2] = measureLevel(amplitude, gain, factorLog2, minimumPhase);
+
+                const auto range = std::minmax_element(std::begin(levels), std::end(levels));
+                const bool ok = *range.second - *range.first <= kLevelTolerance;
+                std::cout << (ok ? "ok   " : "FAIL ") << (minimumPhase ? "min " : "lin ") << "dist " << dist
+                          << " in " << amplitude << ": 1x/2x/4x/8x RMS" << std::fixed << std::setprecision(4);
+                for (const double level : levels)
+                    std::cout << " " << level;
+                std::cout << std::defaultfloat << std::endl;
+                failures += ok ? 0 : 1;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+//==============================================================================
+// Streams with equal settings share SIMD groups; a lane must not see its
+// neighbours, so every stream has to come out as if it ran alone
+std::vector<float> renderBatch(const std::vector<MT2StreamParams>& params,
+                               const std::vector<std::vector<float>>& inputs, int chunkSize)
+{
+    MT2BatchConfig config;
+    mt2_batch_config_init(&config);
+    config.numStreams = static_cast<int>(params.size());
+    config.sampleRate = kSampleRate;
+    config.maxBlockSize = 256;
+
+    std::vector<float> result;
+    MT2Batch* batch = mt2_batch_create(&config);
+    if (batch == nullptr)
+        return result;
+    for (int s = 0; s < config.numStreams; ++s)
+        mt2_batch_set_stream_params(batch, s, &params[static_cast<size_t>(s)]);
+    mt2_batch_start(batch);
+
+    const int numSamples = static_cast<int>(inputs.front().size());
+    std::vector<std::vector<float>> outputs(params.size(), std::vector<float>(static_cast<size_t>(numSamples)));
+    std::vector<const float*> in(params.size());
+    std::vector<float*> out(params.size());
+    for (int pos = 0; pos < numSamples; pos += chunkSize) {
+        for (size_t s = 0; s < params.size(); ++s) {
+            in[s] = inputs[s].data() + pos;
+            out[s] = outputs[s].data() + pos;
+        }
+        mt2_batch_process(batch, in.data(), out.data(), std::min(chunkSize, numSamples - pos));
+    }
+    mt2_batch_destroy(batch);
+
+    for (const auto& output : outputs)
+        result.insert(result.end(), output.begin(), output.end());
+    return result;
+}
+
+int runBatch()
+{
+    MT2StreamParams plain, tanhBright, circuitGe, unlinked;
+    mt2_stream_params_init(&plain);
+    tanhBright = circuitGe = unlinked = plain;
+    tanhBright.clipMode = 1;
+    tanhBright.eqHigh = 1.0f;
+    circuitGe.circuitModel = 1;
+    circuitGe.diodeMorph = 0.375f;
+    unlinked.dist = 0.9f;
+    unlinked.diodeLink = 0;
+    unlinked.diodeMorph2 = 0.6f;
+    unlinked.satPosition = 0;
+
+    // 6 + 3 + 1 + 1 streams, interleaved: a quad, pairs and singles
+    const std::vector<MT2StreamParams> params = { plain, tanhBright, plain, circuitGe, plain, tanhBright,
+                                                  plain, unlinked, plain, tanhBright, plain };
+
+    // A different signal per stream
+    const int numSamples = 4 * kSignalLength;
+    std::vector<std::vector<float>> inputs;
+    for (size_t s = 0; s < params.size(); ++s) {
+        std::mt19937 rng(static_cast<std::uint32_t>(s + 1));
+        std::vector<float> x(static_cast<size_t>(numSamples));
+        for (int i = 0; i < numSamples; ++i)
+            x[static_cast<size_t>(i)] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * (80.0 + 30.0 * s) * i / kSampleRate)
+                                                           + 0.1 * (static_cast<double>(rng()) / 4294967296.0 * 2.0 - 1.0));
+        inputs.push_back(std::move(x));
+    }
+
+    // Chunks longer than the block size and not a multiple of it
+    const auto together = renderBatch(params, inputs, 300);
+
+    int failures = 0;
+    for (size_t s = 0; s < params.size(); ++s) {
+        const auto alone = renderBatch({ params[s] }, { inputs[s] }, 300);
+        double worst = alone.size() == static_cast<size_t>(numSamples) ? 0.0 : 1.0;
+        for (size_t i = 0; i < alone.size() && worst == 0.0; ++i)
+            worst = std::max(worst, std::abs(static_cast<double>(together[s * static_cast<size_t>(numSamples) + i]) - alone[i]));
+        const bool ok = worst == 0.0;
+        std::cout << (ok ? "ok   " : "FAIL ") << "stream " << s << (ok ? "" : " differs from its solo render") << std::endl;
+        failures += ok ? 0 : 1;
+    }
+
+    // The C interface refuses misuse instead of crashing
+    MT2BatchConfig bad;
+    mt2_batch_config_init(&bad);
+    bad.maxBlockSize = 0;
+    MT2BatchConfig good;
+    mt2_batch_config_init(&good);
+    MT2Batch* batch = mt2_batch_create(&good);
+    const float silence[4] = {};
+    const float* in = silence;
+    float out[4];
+    float* outPtr = out;
+    const bool refused = mt2_batch_create(&bad) == nullptr
+                      && mt2_batch_process(batch, &in, &outPtr, 4) == MT2_ERROR_NOT_STARTED
+                      && mt2_batch_set_stream_params(batch, 1, &plain) == MT2_ERROR_ARGUMENT
+                      && mt2_batch_start(batch) == MT2_OK
+                      && mt2_batch_process(batch, &in, &outPtr, 4) == MT2_OK;
+    mt2_batch_destroy(batch);
+    std::cout << (refused ? "ok   " : "FAIL ") << "argument checks" << std::endl;
+    failures += refused ? 0 : 1;
+
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if ((mode == "golden" || mode == "update") && argc == 3)
+        return runGolden(argv[2], mode == "update");
+    if (mode == "performance" && argc == 2)
+        return runPerformance();
+    if (mode == "batch" && argc == 2)
+        return runBatch();
+    if (mode == "level" && argc == 2)
+        return runLevel();
+
+    std::cerr << "usage: MetalCosmosDspTests golden <referenceDir>\n"
+              << "       MetalCosmosDspTests update <referenceDir>\n"
+              << "       MetalCosmosDspTests performance\n"
+              << "       MetalCosmosDspTests batch\n"
+              << "       MetalCosmosDspTests level" << std::endl;
+    return 2;
+}
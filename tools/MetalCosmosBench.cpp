@@ -0,0 +1,685 @@
+// MetalCosmosBench — microbenchmarks for the DSP kernels and MT2Plugin::processBlock
+//
+// Every case runs at each block size (32/64/256/1024) and sample rate
+// (44.1/48/96/192 kHz) and reports ns/sample, ns/block, cycles/sample
+// (x86 TSC; omitted elsewhere) and heap allocations per block.
+//
+// Usage:
+//   MetalCosmosBench [--format table|csv|json] [--out <file>] [--filter <text>]
+//                    [--min-time <ms>]
+//   MetalCosmosBench --accuracy     fastmath error vs libm, then float vs double
+//                                   processBlock per clip mode
+//   MetalCosmosBench --iterations   diode solver iterations and error per
+//                                   predictor / step / quality
+
+#include <juce_events/juce_events.h>
+#include "PluginProcessor.h"
+#include "DSP/BiquadFilter.h"
+#include "DSP/DiodeFeedbackClipper.h"
+#include "DSP/DiodeMorpher.h"
+#include "DSP/DiodeTransferTable.h"
+#include "DSP/FastMath.h"
+#include "DSP/MT2GainStage.h"
+#include "DSP/Oversampler.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+  #define MT2_BENCH_HAS_TSC 1
+#else
+  #define MT2_BENCH_HAS_TSC 0
+#endif
+
+//==============================================================================
+// Allocation counting: every global operator new in the process is counted, so
+// allocations made by JUCE inside processBlock show up as well.
+namespace {
+    std::atomic<std::uint64_t> gAllocationCount { 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+//==============================================================================
+inline std::uint64_t readCycleCounter()
+{
+#if MT2_BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Runs one block of `blockSize` samples. Created per (sampleRate, blockSize).
+using BlockRunner = std::function<void()>;
+
+struct BenchCase {
+    juce::String group;
+    juce::String name;
+    std::function<BlockRunner(double sampleRate, int blockSize)> make;
+};
+
+struct BenchResult {
+    juce::String group, name;
+    double sampleRate = 0.0;
+    int blockSize = 0;
+    double nsPerSample = 0.0;
+    double nsPerBlock = 0.0;
+    double cyclesPerSample = 0.0;
+    double allocsPerBlock = 0.0;
+};
+
+volatile double gSink = 0.0; // keeps results observable to the optimiser
+
+// Deterministic guitar-ish test signal: decaying partials plus a little noise
+std::vector<double> makeInput(int numSamples, double sampleRate)
+{
+    std::vector<double> x(static_cast<size_t>(numSamples));
+    juce::Random rng(0x4d54);
+    for (int i = 0; i < numSamples; ++i) {
+        const double t = i / sampleRate;
+        x[static_cast<size_t>(i)] = 0.4 * std::sin(2.0 * M_PI * 110.0 * t)
+                                  + 0.2 * std::sin(2.0 * M_PI * 220.7 * t)
+                                  + 0.05 * (rng.nextDouble() * 2.0 - 1.0);
+    }
+    return x;
+}
+
+// Shared per-runner scratch so every case sees the same input
+struct Scratch {
+    Scratch(double sampleRate, int blockSize)
+        : in(makeInput(blockSize, sampleRate)), out(static_cast<size_t>(blockSize)) {}
+    std::vector<double> in, out;
+};
+
+std::vector<BenchCase> makeCases()
+{
+    std::vector<BenchCase> cases;
+
+    // --- DiodeFeedbackClipper: one case per DiodeMorpher model and solver ---
+    const std::pair<const char*, float> diodes[] = {
+        { "Si", 0.0f }, { "Ge", 0.25f }, { "LED", 0.5f }, { "Schottky", 0.75f }, { "NoClip", 1.0f }
+    };
+    auto diodeTable = DiodeTransferTable::getShared();
+    const std::pair<const char*, DiodeFeedbackClipper::Solver> solvers[] = {
+        { "", DiodeFeedbackClipper::Solver::Newton },
+        { " (table)", DiodeFeedbackClipper::Solver::Table },
+        { " (omega)", DiodeFeedbackClipper::Solver::Omega },
+    };
+    for (const auto& solver : solvers) {
+        for (const auto& d : diodes) {
+            const float morph = d.second;
+            const auto solverType = solver.second;
+            cases.push_back({ "DiodeFeedbackClipper", juce::String(d.first) + solver.first,
+                              [morph, solverType, diodeTable](double sr, int block) {
+                auto scratch = std::make_shared<Scratch>(sr, block);
+                auto clipper = std::make_shared<DiodeFeedbackClipper>();
+                const auto params = DiodeMorpher().getMorphedParams(morph);
+                clipper->setSampleRate(sr);
+                clipper->setRf(10000.0);
+                clipper->setGain(5.6 * std::pow(200.0 / 5.6, 0.5));
+                clipper->setDiodeParams(params.is, params.n);
+                clipper->setBypass(params.noClip);
+                clipper->setTransferTable(diodeTable.get());
+                clipper->setSolver(solverType);
+                return [scratch, clipper, diodeTable, block] {
+                    for (int i = 0; i < block; ++i)
+                        scratch->out[static_cast<size_t>(i)] = clipper->processSample(scratch->in[static_cast<size_t>(i)]);
+                    gSink = gSink + scratch->out[0];
+                };
+            }});
+        }
+    }
+
+    // --- DiodeFeedbackClipper: iterative solve per predictor / step (Si, Normal quality) ---
+    using Clipper = DiodeFeedbackClipper;
+    const std::pair<const char*, Clipper::Predictor> predictors[] = {
+        { "prev", Clipper::Predictor::Previous },
+        { "linear", Clipper::Predictor::Linear },
+        { "analytic", Clipper::Predictor::Analytic },
+    };
+    for (const auto& predictor : predictors) {
+        for (const auto step : { Clipper::Step::Newton, Clipper::Step::Halley }) {
+            const auto predictorType = predictor.second;
+            cases.push_back({ "DiodeFeedbackClipper",
+                              juce::String(predictor.first) + (step == Clipper::Step::Halley ? "+halley" : "+newton"),
+                              [predictorType, step](double sr, int block) {
+                auto scratch = std::make_shared<Scratch>(sr, block);
+                auto clipper = std::make_shared<Clipper>();
+                const auto params = DiodeMorpher().getMorphedParams(0.0f);
+                clipper->setSampleRate(sr);
+                clipper->setGain(5.6 * std::pow(200.0 / 5.6, 0.5));
+                clipper->setDiodeParams(params.is, params.n);
+                clipper->setPredictor(predictorType);
+                clipper->setStep(step);
+                return [scratch, clipper, block] {
+                    clipper->process(scratch->in.data(), scratch->out.data(), block);
+                    gSink = gSink + scratch->out[0];
+                };
+            }});
+        }
+    }
+
+    // --- MT2GainStage::applyClip: the static clip modes 1-5 ---
+    // Diode mode never goes through applyClip (mode 0 there is only the tanh fallback)
+    const char* clipNames[] = { "", "Tanh", "Atan", "Hard", "Asymmetric", "Foldback" };
+    for (int mode = 1; mode < 6; ++mode) {
+        cases.push_back({ "MT2GainStage::applyClip", clipNames[mode], [mode](double sr, int block) {
+            auto scratch = std::make_shared<Scratch>(sr, block);
+            for (auto& v : scratch->in)
+                v *= 30.0; // typical post-gain level
+            return [scratch, block, mode] {
+                for (int i = 0; i < block; ++i)
+                    scratch->out[static_cast<size_t>(i)] = MT2GainStage<double>::applyClip(scratch->in[static_cast<size_t>(i)], mode);
+                gSink = gSink + scratch->out[0];
+            };
+        }});
+    }
+
+    // --- fastmath vs libm over a block at typical post-gain levels ---
+    // The kernel is a lambda type, so it inlines into the block loop
+    auto addKernel = [&cases](const char* name, auto f) {
+        cases.push_back({ "FastMath", name, [f](double sr, int block) {
+            auto scratch = std::make_shared<Scratch>(sr, block);
+            for (auto& v : scratch->in)
+                v *= 30.0;
+            return [scratch, block, f] {
+                for (int i = 0; i < block; ++i)
+                    scratch->out[static_cast<size_t>(i)] = f(scratch->in[static_cast<size_t>(i)]);
+                gSink = gSink + scratch->out[0];
+            };
+        }});
+    };
+    addKernel("std::tanh", [](double x) { return std::tanh(x); });
+    addKernel("fastmath::tanh", [](double x) { return fastmath::tanh(x); });
+    addKernel("std::atan", [](double x) { return std::atan(x); });
+    addKernel("fastmath::atan", [](double x) { return fastmath::atan(x); });
+    addKernel("std::sin", [](double x) { return std::sin(x); });
+    addKernel("fastmath::sin", [](double x) { return fastmath::sin(x); });
+    addKernel("std::sinh+cosh", [](double x) { return std::sinh(x) + std::cosh(x); });
+    addKernel("fastmath::sinhcosh", [](double x) { double s, c; fastmath::sinhcosh(x, s, c); return s + c; });
+
+    // --- MT2GainStage::process: static clip modes with and without ADAA ---
+    for (int mode = 1; mode < 6; ++mode) {
+        for (bool adaa : { false, true }) {
+            cases.push_back({ "MT2GainStage::process", juce::String(clipNames[mode]) + (adaa ? " (ADAA)" : ""),
+                              [mode, adaa, diodeTable](double sr, int block) {
+                auto scratch = std::make_shared<Scratch>(sr, block);
+                auto stage = std::make_shared<MT2GainStage<double>>();
+                stage->setDiodeTable(diodeTable);
+                stage->prepare(sr);
+                stage->setGain(30.0);
+                stage->setClipMode(mode);
+                stage->setAntialiasing(adaa);
+                return [scratch, stage, block] {
+                    stage->process(scratch->in.data(), scratch->out.data(), block);
+                    gSink = gSink + scratch->out[0];
+                };
+            }});
+        }
+    }
+
+    // --- MT2GainStage::process: Diode mode, classic chain vs circuit model ---
+    using Engine = MT2GainStage<double>::Engine;
+    for (auto engine : { Engine::Classic, Engine::Circuit }) {
+        cases.push_back({ "MT2GainStage::process", engine == Engine::Circuit ? "Diode (circuit)" : "Diode (classic)",
+                          [engine, diodeTable](double sr, int block) {
+            auto scratch = std::make_shared<Scratch>(sr, block);
+            auto stage = std::make_shared<MT2GainStage<double>>();
+            stage->setDiodeTable(diodeTable);
+            stage->prepare(sr);
+            stage->setGain(60.0);
+            stage->setEngine(engine);
+            return [scratch, stage, block] {
+                stage->process(scratch->in.data(), scratch->out.data(), block);
+                gSink = gSink + scratch->out[0];
+            };
+        }});
+    }
+
+    // --- BiquadFilter: sample path and coefficient paths ---
+    cases.push_back({ "BiquadFilter", "processSample", [](double sr, int block) {
+        auto scratch = std::make_shared<Scratch>(sr, block);
+        auto filter = std::make_shared<BiquadFilter<double>>();
+        filter->setPeak(1000.0, 6.0, 0.7, sr);
+        return [scratch, filter, block] {
+            for (int i = 0; i < block; ++i)
+                scratch->out[static_cast<size_t>(i)] = filter->processSample(scratch->in[static_cast<size_t>(i)]);
+            gSink = gSink + scratch->out[0];
+        };
+    }});
+
+    // Coefficient paths run once per block, as MT2ToneStack does
+    using Setter = void (BiquadFilter<double>::*)(double, double, double, double);
+    const std::pair<const char*, Setter> setters[] = {
+        { "setLowShelf", &BiquadFilter<double>::setLowShelf },
+        { "setPeak", &BiquadFilter<double>::setPeak },
+        { "setHighShelf", &BiquadFilter<double>::setHighShelf },
+    };
+    for (const auto& s : setters) {
+        const Setter setter = s.second;
+        cases.push_back({ "BiquadFilter", s.first, [setter](double sr, int) {
+            auto filter = std::make_shared<BiquadFilter<double>>();
+            auto gainDb = std::make_shared<double>(0.0);
+            return [filter, gainDb, setter, sr] {
+                *gainDb = *gainDb > 10.0 ? -10.0 : *gainDb + 0.37; // defeat hoisting
+                ((*filter).*setter)(1000.0, *gainDb, 0.707, sr);
+                gSink = gSink + filter->processSample(1.0);
+            };
+        }});
+    }
+
+    // --- Oversampler: stereo up + down round trip (cost per base-rate sample) ---
+    using StereoOversampler = Oversampler<simd::Double2>;
+    for (auto phase : { StereoOversampler::Phase::Linear, StereoOversampler::Phase::Minimum }) {
+        for (int factorLog2 = 1; factorLog2 <= StereoOversampler::MAX_STAGES; ++factorLog2) {
+            const juce::String name = juce::String(1 << factorLog2) + "x "
+                                    + (phase == StereoOversampler::Phase::Linear ? "linear" : "min-phase");
+            cases.push_back({ "Oversampler", name, [phase, factorLog2](double sr, int block) {
+                auto scratch = std::make_shared<Scratch>(sr, block);
+                auto lanes = std::make_shared<std::vector<simd::Double2>>(static_cast<size_t>(block));
+                for (int i = 0; i < block; ++i)
+                    (*lanes)[static_cast<size_t>(i)] = simd::Lanes<simd::Double2>::broadcast(scratch->in[static_cast<size_t>(i)]);
+                auto oversampler = std::make_shared<StereoOversampler>();
+                oversampler->prepare(block);
+                oversampler->setConfig(factorLog2, phase);
+                return [oversampler, lanes, block] {
+                    oversampler->processUp(lanes->data(), block);
+                    oversampler->processDown(lanes->data(), block);
+                    gSink = gSink + simd::Lanes<simd::Double2>::get((*lanes)[0], 0);
+                };
+            }});
+        }
+    }
+
+    // --- Full plugin (metered = as with the editor open; 8ch = a 7.1 bus, two 4-lane groups) ---
+    // Channels get slightly different levels so that they really are
+    // independent; dual mono feeds every channel the same samples.
+    struct PluginCase { float dist; bool metered; int numChannels; bool dualMono; };
+    const PluginCase pluginCases[] = { { 0.5f, false, 2, false }, { 1.0f, false, 2, false }, { 0.5f, true, 2, false },
+                                       { 0.5f, false, 8, false }, { 0.5f, false, 1, false }, { 0.5f, false, 2, true } };
+    for (const auto& pc : pluginCases) {
+        cases.push_back({ "MT2Plugin::processBlock", "dist=" + juce::String(pc.dist, 1) + (pc.metered ? " metered" : "")
+                                                     + (pc.numChannels != 2 ? " " + juce::String(pc.numChannels) + "ch" : "")
+                                                     + (pc.dualMono ? " dual mono" : ""),
+                          [pc](double sr, int block) {
+            auto plugin = std::make_shared<MT2Plugin>();
+            if (auto* p = plugin->apvts.getParameter("dist"))
+                p->setValueNotifyingHost(pc.dist);
+            if (pc.metered)
+                plugin->getLoadMeter().attach();
+            plugin->setPlayConfigDetails(pc.numChannels, pc.numChannels, sr, block);
+            plugin->prepareToPlay(sr, block);
+
+            const int numChannels = pc.numChannels;
+            auto buffer = std::make_shared<juce::AudioBuffer<float>>(numChannels, block);
+            auto input = makeInput(block, sr);
+            auto midi = std::make_shared<juce::MidiBuffer>();
+            const bool dualMono = pc.dualMono;
+            // Refilling the input is part of the measured time (channels * block float stores)
+            return [plugin, buffer, midi, input, block, numChannels, dualMono] {
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    const double level = dualMono ? 1.0 : 1.0 - 0.05 * ch;
+                    for (int i = 0; i < block; ++i)
+                        buffer->setSample(ch, i, static_cast<float>(level * input[static_cast<size_t>(i)]));
+                }
+                plugin->processBlock(*buffer, *midi);
+                gSink = gSink + buffer->getSample(0, 0);
+            };
+        }});
+    }
+
+    // Host-supplied double buffers (no float conversion on either side)
+    cases.push_back({ "MT2Plugin::processBlock", "dist=0.5 double", [](double sr, int block) {
+        auto plugin = std::make_shared<MT2Plugin>();
+        plugin->setPlayConfigDetails(2, 2, sr, block);
+        plugin->setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+        plugin->prepareToPlay(sr, block);
+
+        auto buffer = std::make_shared<juce::AudioBuffer<double>>(2, block);
+        auto input = makeInput(block, sr);
+        auto midi = std::make_shared<juce::MidiBuffer>();
+        return [plugin, buffer, midi, input, block] {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < block; ++i)
+                    buffer->setSample(ch, i, (1.0 - 0.05 * ch) * input[static_cast<size_t>(i)]);
+            plugin->processBlock(*buffer, *midi);
+            gSink = gSink + buffer->getSample(0, 0);
+        };
+    }});
+
+    return cases;
+}
+
+// Runs the same input through the float and the double processBlock and
+// reports how far the float output is from the double one. The DSP runs in
+// double in both cases, so the difference is the float rounding of input
+// and output (about -150 dB re full scale for a well-scaled signal).
+// Maximum absolute and ulp error of one fastmath function against libm
+// (evaluated in double) over log-spaced and uniform samples of [-range, range]
+template <typename T, typename Fast, typename Reference>
+void reportFastMathError(const char* name, double range, Fast fast, Reference reference)
+{
+    juce::Random rng(0x464d);
+    double maxAbs = 0.0, maxUlp = 0.0;
+    for (int i = 0; i < 1000000; ++i) {
+        const double scale = (i % 2 == 0) ? 1.0 : std::pow(10.0, -rng.nextDouble() * 8.0);
+        const T x = static_cast<T>((rng.nextDouble() * 2.0 - 1.0) * range * scale);
+        const double ref = reference(static_cast<double>(x));
+        const double err = std::abs(static_cast<double>(fast(x)) - ref);
+        const T refT = static_cast<T>(std::abs(ref));
+        const double ulp = static_cast<double>(std::nextafter(refT, std::numeric_limits<T>::infinity()) - refT);
+        maxAbs = juce::jmax(maxAbs, err);
+        if (ulp > 0.0 && std::isfinite(ulp))
+            maxUlp = juce::jmax(maxUlp, err / ulp);
+    }
+    std::cout << juce::String(name).paddedRight(' ', 10)
+              << juce::String(std::is_same_v<T, float> ? "float" : "double").paddedRight(' ', 8)
+              << juce::String(range).paddedLeft(' ', 8)
+              << juce::String(maxAbs, 3, true).paddedLeft(' ', 14)
+              << juce::String(maxUlp, 2).paddedLeft(' ', 10) << std::endl;
+}
+
+template <typename T>
+void reportFastMathErrors()
+{
+    const bool isFloat = std::is_same_v<T, float>;
+    reportFastMathError<T>("exp", isFloat ? 86.0 : 700.0, [](T x) { return fastmath::exp(x); },
+                           [](double x) { return std::exp(x); });
+    reportFastMathError<T>("tanh", 30.0, [](T x) { return fastmath::tanh(x); },
+                           [](double x) { return std::tanh(x); });
+    reportFastMathError<T>("atan", 1.0e4, [](T x) { return fastmath::atan(x); },
+                           [](double x) { return std::atan(x); });
+    reportFastMathError<T>("sinh", isFloat ? 86.0 : 700.0, [](T x) { T s, c; fastmath::sinhcosh(x, s, c); return s; },
+                           [](double x) { return std::sinh(x); });
+    reportFastMathError<T>("cosh", isFloat ? 86.0 : 700.0, [](T x) { T s, c; fastmath::sinhcosh(x, s, c); return c; },
+                           [](double x) { return std::cosh(x); });
+    reportFastMathError<T>("sin", isFloat ? 1.0e3 : 1.0e5, [](T x) { return fastmath::sin(x); },
+                           [](double x) { return std::sin(x); });
+    reportFastMathError<T>("log|x|", 1.0e6, [](T x) { return fastmath::log(std::abs(x)); },
+                           [](double x) { return std::log(std::abs(x)); });
+    reportFastMathError<T>("omega", 50.0, [](T x) { return fastmath::omega(x); },
+                           [](double x) {
+                               // e^t + t = x with t = ln(y) is convex: Newton from above converges
+                               double t = x > 1.0 ? std::log(x) : x;
+                               for (int i = 0; i < 100; ++i)
+                                   t -= (std::exp(t) + t - x) / (std::exp(t) + 1.0);
+                               return std::exp(t);
+                           });
+}
+
+int runAccuracyCheck()
+{
+    std::cout << "fastmath  type       range     max |error|   max ulp" << std::endl;
+    reportFastMathErrors<double>();
+    reportFastMathErrors<float>();
+    std::cout << std::endl;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+    const int numBlocks = 375;   // 2 s
+    const char* clipNames[] = { "Diode", "Tanh", "Atan", "Hard", "Asymmetric", "Foldback" };
+
+    std::cout << "clip mode     max |float - double|   error re output RMS" << std::endl;
+    for (int mode = 0; mode < 6; ++mode) {
+        MT2Plugin floatPlugin, doublePlugin;
+        for (auto* plugin : { &floatPlugin, &doublePlugin }) {
+            if (auto* p = plugin->apvts.getParameter("clip_mode"))
+                p->setValueNotifyingHost(p->convertTo0to1(static_cast<float>(mode)));
+            plugin->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        }
+        doublePlugin.setProcessingPrecision(juce::AudioProcessor::doublePrecision);
+        floatPlugin.prepareToPlay(sampleRate, blockSize);
+        doublePlugin.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> floatBuffer(2, blockSize);
+        juce::AudioBuffer<double> doubleBuffer(2, blockSize);
+        juce::MidiBuffer midi;
+        const auto input = makeInput(blockSize * numBlocks, sampleRate);
+
+        double maxError = 0.0, errorEnergy = 0.0, signalEnergy = 0.0;
+        for (int b = 0; b < numBlocks; ++b) {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i) {
+                    const double x = input[static_cast<size_t>(b * blockSize + i)];
+                    floatBuffer.setSample(ch, i, static_cast<float>(x));
+                    doubleBuffer.setSample(ch, i, x);
+                }
+            floatPlugin.processBlock(floatBuffer, midi);
+            doublePlugin.processBlock(doubleBuffer, midi);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i) {
+                    const double ref = doubleBuffer.getSample(ch, i);
+                    const double err = static_cast<double>(floatBuffer.getSample(ch, i)) - ref;
+                    maxError = juce::jmax(maxError, std::abs(err));
+                    errorEnergy += err * err;
+                    signalEnergy += ref * ref;
+                }
+        }
+
+        const double relDb = 10.0 * std::log10(juce::jmax(errorEnergy, 1.0e-300) / juce::jmax(signalEnergy, 1.0e-300));
+        std::cout << juce::String(clipNames[mode]).paddedRight(' ', 14)
+                  << juce::String(maxError, 12).paddedLeft(' ', 20)
+                  << (juce::String(relDb, 1) + " dB").paddedLeft(' ', 22) << std::endl;
+    }
+    return 0;
+}
+
+int runIterationReport()
+{
+    using Clipper = DiodeFeedbackClipper;
+    const double sampleRate = 96000.0;   // 2x oversampled 48 kHz
+    const auto input = makeInput(1 << 16, sampleRate);
+    const int numSamples = static_cast<int>(input.size());
+    const double gains[] = { 5.6, 33.5, 200.0 };   // dist 0, 0.5, 1
+
+    const char* predictorNames[] = { "prev", "linear", "analytic" };
+    const char* stepNames[] = { "newton", "halley" };
+    const char* qualityNames[] = { "eco", "normal", "high" };
+
+    std::cout << "quality  predictor  step      avg iter  max iter   max |error| V" << std::endl;
+    for (int q = 0; q < 3; ++q)
+        for (int p = 0; p < 3; ++p)
+            for (int s = 0; s < 2; ++s) {
+                Clipper::IterationStats stats;
+                double maxError = 0.0;
+
+                for (const double gain : gains) {
+                    Clipper reference, clipper;
+                    for (auto* c : { &reference, &clipper }) {
+                        c->setSampleRate(sampleRate);
+                        c->setGain(gain);
+                    }
+                    reference.setQuality(Clipper::Quality::High);
+                    reference.setPredictor(Clipper::Predictor::Analytic);
+                    clipper.setQuality(static_cast<Clipper::Quality>(q));
+                    clipper.setPredictor(static_cast<Clipper::Predictor>(p));
+                    clipper.setStep(static_cast<Clipper::Step>(s));
+
+                    std::vector<double> expected(input.size()), actual(input.size());
+                    reference.process(input.data(), expected.data(), numSamples);
+                    clipper.process(input.data(), actual.data(), numSamples);
+                    for (size_t i = 0; i < input.size(); ++i)
+                        maxError = juce::jmax(maxError, std::abs(actual[i] - expected[i]));
+                    stats.merge(clipper.getIterationStats());
+                }
+
+                std::cout << juce::String(qualityNames[q]).paddedRight(' ', 9)
+                          << juce::String(predictorNames[p]).paddedRight(' ', 11)
+                          << juce::String(stepNames[s]).paddedRight(' ', 8)
+                          << juce::String(stats.getAverage(), 2).paddedLeft(' ', 10)
+                          << juce::String(stats.maxIterations).paddedLeft(' ', 10)
+                          << juce::String(maxError, 12).paddedLeft(' ', 16) << std::endl;
+            }
+    return 0;
+}
+
+BenchResult runCase(const BenchCase& c, double sampleRate, int blockSize, double minTimeMs)
+{
+    auto runner = c.make(sampleRate, blockSize);
+
+    // Warm up caches, branch predictors and the Newton warm-start
+    for (int i = 0; i < 16; ++i)
+        runner();
+
+    std::int64_t blocks = 0;
+    std::uint64_t cycles = 0;
+    std::uint64_t allocs = 0;
+    const auto minTicks = juce::Time::secondsToHighResolutionTicks(minTimeMs * 0.001);
+    const auto start = juce::Time::getHighResolutionTicks();
+    juce::int64 elapsed = 0;
+
+    do {
+        const auto allocsBefore = gAllocationCount.load(std::memory_order_relaxed);
+        const auto c0 = readCycleCounter();
+        for (int i = 0; i < 64; ++i)
+            runner();
+        cycles += readCycleCounter() - c0;
+        allocs += gAllocationCount.load(std::memory_order_relaxed) - allocsBefore;
+        blocks += 64;
+        elapsed = juce::Time::getHighResolutionTicks() - start;
+    } while (elapsed < minTicks);
+
+    BenchResult r;
+    r.group = c.group;
+    r.name = c.name;
+    r.sampleRate = sampleRate;
+    r.blockSize = blockSize;
+    const double ns = juce::Time::highResolutionTicksToSeconds(elapsed) * 1.0e9;
+    const double samples = static_cast<double>(blocks) * blockSize;
+    r.nsPerSample = ns / samples;
+    r.nsPerBlock = ns / static_cast<double>(blocks);
+    r.cyclesPerSample = static_cast<double>(cycles) / samples;
+    r.allocsPerBlock = static_cast<double>(allocs) / static_cast<double>(blocks);
+    return r;
+}
+
+juce::String formatResults(const std::vector<BenchResult>& results, const juce::String& format)
+{
+    juce::String out;
+
+    if (format == "json") {
+        juce::Array<juce::var> rows;
+        for (const auto& r : results) {
+            auto* obj = new juce::DynamicObject();
+            obj->setProperty("group", r.group);
+            obj->setProperty("case", r.name);
+            obj->setProperty("sample_rate", r.sampleRate);
+            obj->setProperty("block_size", r.blockSize);
+            obj->setProperty("ns_per_sample", r.nsPerSample);
+            obj->setProperty("ns_per_block", r.nsPerBlock);
+            obj->setProperty("cycles_per_sample", MT2_BENCH_HAS_TSC ? juce::var(r.cyclesPerSample) : juce::var());
+            obj->setProperty("allocs_per_block", r.allocsPerBlock);
+            rows.add(juce::var(obj));
+        }
+        auto* root = new juce::DynamicObject();
+        root->setProperty("version", METALCOSMOS_VERSION);
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("results", rows);
+        return juce::JSON::toString(juce::var(root));
+    }
+
+    const bool csv = format == "csv";
+    out << (csv ? "group,case,sample_rate,block_size,ns_per_sample,ns_per_block,cycles_per_sample,allocs_per_block\n"
+                : "group                      case              rate    block   ns/smp    ns/block  cyc/smp  allocs/blk\n");
+
+    for (const auto& r : results) {
+        const auto cyc = MT2_BENCH_HAS_TSC ? juce::String(r.cyclesPerSample, 2) : juce::String(csv ? "" : "n/a");
+        if (csv) {
+            out << r.group << "," << r.name << "," << r.sampleRate << "," << r.blockSize << ","
+                << juce::String(r.nsPerSample, 3) << "," << juce::String(r.nsPerBlock, 1) << ","
+                << cyc << "," << juce::String(r.allocsPerBlock, 3) << "\n";
+        } else {
+            out << r.group.paddedRight(' ', 27) << r.name.paddedRight(' ', 18)
+                << juce::String(r.sampleRate / 1000.0, 1).paddedLeft(' ', 5) << "k"
+                << juce::String(r.blockSize).paddedLeft(' ', 7)
+                << juce::String(r.nsPerSample, 2).paddedLeft(' ', 9)
+                << juce::String(r.nsPerBlock, 0).paddedLeft(' ', 12)
+                << cyc.paddedLeft(' ', 9)
+                << juce::String(r.allocsPerBlock, 2).paddedLeft(' ', 12) << "\n";
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::String format = "table";
+    juce::String filter;
+    juce::File outFile;
+    double minTimeMs = 50.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--format" && hasValue)        format = argv[++i];
+        else if (arg == "--filter" && hasValue)   filter = argv[++i];
+        else if (arg == "--out" && hasValue)      outFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--min-time" && hasValue) minTimeMs = juce::jmax(1.0, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--accuracy")              return runAccuracyCheck();
+        else if (arg == "--iterations")            return runIterationReport();
+        else {
+            std::cerr << "usage: MetalCosmosBench [--format table|csv|json] [--out file] [--filter text] [--min-time ms]\n"
+                      << "       MetalCosmosBench --accuracy\n"
+                      << "       MetalCosmosBench --iterations" << std::endl;
+            return 2;
+        }
+    }
+
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    const int blockSizes[] = { 32, 64, 256, 1024 };
+
+    std::vector<BenchResult> results;
+    for (const auto& c : makeCases()) {
+        if (filter.isNotEmpty() && !(c.group + " " + c.name).containsIgnoreCase(filter))
+            continue;
+        for (double sr : sampleRates)
+            for (int block : blockSizes) {
+                results.push_back(runCase(c, sr, block, minTimeMs));
+                std::cerr << "." << std::flush;
+            }
+    }
+    std::cerr << std::endl;
+
+    const auto text = formatResults(results, format);
+    if (outFile != juce::File()) {
+        if (!outFile.replaceWithText(text)) {
+            std::cerr << "cannot write " << outFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << text << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,379 @@
+// MetalCosmosRender — headless batch reamp renderer
+//
+// Drives MT2Plugin::processBlock (GainStage → ToneStack → output saturation)
+// over WAV/AIFF files without a host. Files are rendered in parallel by a pool
+// of worker threads, each owning its own MT2Plugin instance.
+//
+// Usage:
+//   MetalCosmosRender [options] <file-or-directory>...
+//     -o, --out-dir <dir>     output directory (default: next to each input)
+//     -s, --suffix <text>     output file name suffix (default: _mc)
+//     -p, --preset <file>     parameter preset (APVTS XML or "id = value" lines)
+//         --param <id>=<val>  set a parameter in its real range (repeatable)
+//     -j, --jobs <n>          worker threads (default: all cores)
+//     -b, --block <n>         block size passed to processBlock (default: 512)
+//         --bits <n>          output bit depth (default: 24)
+//         --list-params       print parameter IDs and ranges, then exit
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_events/juce_events.h>
+#include "PluginProcessor.h"
+#include <atomic>
+#include <iostream>
+
+namespace {
+
+struct RenderSettings {
+    juce::File outDir;
+    juce::String suffix = "_mc";
+    int blockSize = 512;
+    int bitDepth = 24;
+    int numJobs = juce::SystemStats::getNumCpus();
+    juce::ValueTree presetState;          // optional APVTS state
+    juce::StringPairArray paramValues;    // id -> real value (applied after preset)
+};
+
+struct RenderResult {
+    juce::File input, output;
+    juce::String error;
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    double audioSeconds = 0.0;
+    double dspSeconds = 0.0;
+    double totalSeconds = 0.0;
+};
+
+// Serialises console output from the worker threads.
+class Reporter {
+public:
+    explicit Reporter(int totalFiles) : mTotal(totalFiles) {}
+
+    void report(const RenderResult& r)
+    {
+        const juce::ScopedLock sl(mLock);
+        ++mDone;
+
+        juce::String line = "[" + juce::String(mDone).paddedLeft(' ', juce::String(mTotal).length())
+                          + "/" + juce::String(mTotal) + "] " + r.input.getFileName();
+
+        if (r.error.isNotEmpty()) {
+            ++mFailed;
+            std::cerr << (line + "  FAILED: " + r.error) << std::endl;
+            return;
+        }
+
+        mAudioSeconds += r.audioSeconds;
+        line << "  " << juce::String(r.sampleRate, 0) << " Hz  " << r.numChannels << " ch  "
+             << juce::String(r.audioSeconds, 1) << " s"
+             << "  dsp " << juce::String(r.audioSeconds / juce::jmax(r.dspSeconds, 1.0e-9), 1) << "x"
+             << "  total " << juce::String(r.audioSeconds / juce::jmax(r.totalSeconds, 1.0e-9), 1) << "x"
+             << "  -> " << r.output.getFullPathName();
+        std::cout << line << std::endl;
+    }
+
+    int getNumFailed() const { return mFailed; }
+    double getAudioSeconds() const { return mAudioSeconds; }
+
+private:
+    juce::CriticalSection mLock;
+    const int mTotal;
+    int mDone = 0;
+    int mFailed = 0;
+    double mAudioSeconds = 0.0;
+};
+
+double ticksToSeconds(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks);
+}
+
+// Applies the preset and command-line values. Must run on the message thread.
+juce::String applyParameters(MT2Plugin& plugin, const RenderSettings& settings)
+{
+    if (settings.presetState.isValid())
+        plugin.apvts.replaceState(settings.presetState.createCopy());
+
+    for (const auto& id : settings.paramValues.getAllKeys()) {
+        auto* param = plugin.apvts.getParameter(id);
+        if (param == nullptr)
+            return "unknown parameter '" + id + "' (see --list-params)";
+
+        const float value = settings.paramValues[id].getFloatValue();
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+    return {};
+}
+
+class RenderWorker : public juce::Thread {
+public:
+    RenderWorker(const juce::Array<juce::File>& files, std::atomic<int>& nextFile,
+                 const RenderSettings& settings, Reporter& reporter)
+        : juce::Thread("MetalCosmosRender worker"),
+          mFiles(files), mNextFile(nextFile), mSettings(settings), mReporter(reporter)
+    {
+        mFormats.registerBasicFormats();
+    }
+
+    MT2Plugin& getPlugin() { return mPlugin; }
+
+    void run() override
+    {
+        for (;;) {
+            const int index = mNextFile.fetch_add(1);
+            if (index >= mFiles.size() || threadShouldExit())
+                return;
+            mReporter.report(render(mFiles.getReference(index)));
+        }
+    }
+
+private:
+    juce::File getOutputFile(const juce::File& input) const
+    {
+        auto dir = mSettings.outDir == juce::File() ? input.getParentDirectory() : mSettings.outDir;
+        return dir.getChildFile(input.getFileNameWithoutExtension() + mSettings.suffix
+                                + input.getFileExtension());
+    }
+
+    RenderResult render(const juce::File& input)
+    {
+        RenderResult result;
+        result.input = input;
+        result.output = getOutputFile(input);
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(mFormats.createReaderFor(input));
+        if (reader == nullptr) {
+            result.error = "unreadable or unsupported file";
+            return result;
+        }
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        if (numChannels < 1 || numChannels > MT2Plugin::kMaxChannels) {
+            result.error = "only files with 1 to " + juce::String(MT2Plugin::kMaxChannels) + " channels are supported";
+            return result;
+        }
+
+        auto* format = mFormats.findFormatForFileExtension(result.output.getFileExtension());
+        if (format == nullptr) {
+            result.error = "no writer for " + result.output.getFileExtension();
+            return result;
+        }
+
+        result.output.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream(result.output.createOutputStream());
+        if (stream == nullptr) {
+            result.error = "cannot create " + result.output.getFullPathName();
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            format->createWriterFor(stream.get(), reader->sampleRate,
+                                    static_cast<unsigned int>(numChannels),
+                                    mSettings.bitDepth, {}, 0));
+        if (writer == nullptr) {
+            result.error = "cannot write " + juce::String(mSettings.bitDepth) + "-bit "
+                         + format->getFormatName();
+            return result;
+        }
+        stream.release(); // now owned by the writer
+
+        result.sampleRate = reader->sampleRate;
+        result.numChannels = numChannels;
+        result.audioSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+        result.dspSeconds = process(*reader, *writer);
+        result.totalSeconds = ticksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return result;
+    }
+
+    // Streams the file through the plugin block by block, compensating the
+    // reported latency. Returns the time spent inside processBlock.
+    double process(juce::AudioFormatReader& reader, juce::AudioFormatWriter& writer)
+    {
+        const int numChannels = static_cast<int>(reader.numChannels);
+        const int blockSize = mSettings.blockSize;
+
+        mPlugin.setPlayConfigDetails(numChannels, numChannels, reader.sampleRate, blockSize);
+        mPlugin.setNonRealtime(true);
+        mPlugin.prepareToPlay(reader.sampleRate, blockSize);
+        mPlugin.reset();
+
+        const juce::int64 length = reader.lengthInSamples;
+        const juce::int64 latency = mPlugin.getLatencySamples();
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 dspTicks = 0;
+
+        for (juce::int64 pos = 0; pos < length + latency; pos += blockSize) {
+            const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, length + latency - pos));
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            reader.read(&buffer, 0, numSamples, pos, true, true); // zero-pads past the end
+
+            const auto t0 = juce::Time::getHighResolutionTicks();
+            mPlugin.processBlock(buffer, midi);
+            dspTicks += juce::Time::getHighResolutionTicks() - t0;
+
+            // Drop the first `latency` output samples so the render lines up with the DI
+            const int skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, latency - pos));
+            if (skip < numSamples)
+                writer.writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+        }
+
+        mPlugin.releaseResources();
+        return ticksToSeconds(dspTicks);
+    }
+
+    const juce::Array<juce::File>& mFiles;
+    std::atomic<int>& mNextFile;
+    const RenderSettings& mSettings;
+    Reporter& mReporter;
+    juce::AudioFormatManager mFormats;
+    MT2Plugin mPlugin;
+};
+
+bool isAudioFile(const juce::File& f)
+{
+    return f.hasFileExtension("wav;aif;aiff");
+}
+
+// Expands directories recursively, skipping earlier renders (files ending in the suffix).
+void collectInputs(const juce::File& f, const juce::String& suffix, juce::Array<juce::File>& files)
+{
+    if (f.isDirectory()) {
+        for (const auto& entry : juce::RangedDirectoryIterator(f, true, "*", juce::File::findFiles))
+            if (isAudioFile(entry.getFile()) && !entry.getFile().getFileNameWithoutExtension().endsWith(suffix))
+                files.add(entry.getFile());
+    } else if (f.existsAsFile()) {
+        files.add(f);
+    }
+}
+
+// Preset file: either XML written from apvts.copyState(), or "id = value" lines.
+juce::String loadPreset(const juce::File& file, RenderSettings& settings)
+{
+    if (!file.existsAsFile())
+        return "preset not found: " + file.getFullPathName();
+
+    const auto text = file.loadFileAsString();
+    if (text.trimStart().startsWithChar('<')) {
+        if (auto xml = juce::parseXML(text))
+            settings.presetState = juce::ValueTree::fromXml(*xml);
+        return settings.presetState.isValid() ? juce::String() : "invalid XML preset";
+    }
+
+    for (auto line : juce::StringArray::fromLines(text)) {
+        line = line.upToFirstOccurrenceOf("#", false, false).trim();
+        if (line.isEmpty())
+            continue;
+        if (!line.containsChar('='))
+            return "malformed preset line: " + line;
+        // Command-line --param values win over the preset
+        const auto id = line.upToFirstOccurrenceOf("=", false, false).trim();
+        if (!settings.paramValues.containsKey(id))
+            settings.paramValues.set(id, line.fromFirstOccurrenceOf("=", false, false).trim());
+    }
+    return {};
+}
+
+void printParameters()
+{
+    MT2Plugin plugin;
+    for (auto* p : plugin.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p)) {
+            const auto& range = ranged->getNormalisableRange();
+            std::cout << ranged->paramID << "  [" << range.start << " .. " << range.end
+                      << "]  default " << range.convertFrom0to1(ranged->getDefaultValue()) << std::endl;
+        }
+}
+
+int usage()
+{
+    std::cerr << "usage: MetalCosmosRender [-o dir] [-s suffix] [-p preset] [--param id=value]...\n"
+                 "                         [-j jobs] [-b block] [--bits n] [--list-params] <files|dirs>..."
+              << std::endl;
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    RenderSettings settings;
+    juce::StringArray inputs;
+    juce::File presetFile;
+
+    for (int i = 1; i < argc; ++i) {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if ((arg == "-o" || arg == "--out-dir") && hasValue)  settings.outDir = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if ((arg == "-s" || arg == "--suffix") && hasValue) settings.suffix = argv[++i];
+        else if ((arg == "-p" || arg == "--preset") && hasValue) presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if ((arg == "-j" || arg == "--jobs") && hasValue)   settings.numJobs = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if ((arg == "-b" || arg == "--block") && hasValue)  settings.blockSize = juce::jlimit(16, 65536, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--bits" && hasValue)                    settings.bitDepth = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--param" && hasValue) {
+            const juce::String kv(argv[++i]);
+            if (!kv.containsChar('='))
+                return usage();
+            settings.paramValues.set(kv.upToFirstOccurrenceOf("=", false, false).trim(),
+                                     kv.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (arg == "--list-params") { printParameters(); return 0; }
+        else if (arg.startsWithChar('-')) return usage();
+        else inputs.add(arg);
+    }
+
+    juce::Array<juce::File> files;
+    for (const auto& input : inputs)
+        collectInputs(juce::File::getCurrentWorkingDirectory().getChildFile(input), settings.suffix, files);
+
+    if (presetFile != juce::File()) {
+        const auto error = loadPreset(presetFile, settings);
+        if (error.isNotEmpty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    if (files.isEmpty())
+        return usage();
+
+    if (settings.outDir != juce::File() && !settings.outDir.createDirectory()) {
+        std::cerr << "cannot create output directory " << settings.outDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // One plugin per worker, created and configured here on the message thread
+    Reporter reporter(files.size());
+    std::atomic<int> nextFile { 0 };
+    juce::OwnedArray<RenderWorker> workers;
+
+    for (int i = 0; i < juce::jmin(settings.numJobs, files.size()); ++i) {
+        auto* worker = workers.add(new RenderWorker(files, nextFile, settings, reporter));
+        const auto error = applyParameters(worker->getPlugin(), settings);
+        if (error.isNotEmpty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Rendering " << files.size() << " file(s) on " << workers.size() << " thread(s)" << std::endl;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (auto* w : workers)
+        w->startThread();
+    for (auto* w : workers)
+        w->waitForThreadToExit(-1);
+
+    const double wallSeconds = ticksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    std::cout << "Done: " << files.size() - reporter.getNumFailed() << " ok, "
+              << reporter.getNumFailed() << " failed, "
+              << juce::String(reporter.getAudioSeconds(), 1) << " s of audio in "
+              << juce::String(wallSeconds, 1) << " s ("
+              << juce::String(reporter.getAudioSeconds() / juce::jmax(wallSeconds, 1.0e-9), 1)
+              << "x realtime overall)" << std::endl;
+
+    return reporter.getNumFailed() == 0 ? 0 : 1;
+}